@@ -70,6 +70,9 @@ class Client : public mrpt::system::COutputLogger
 	template <typename T>
 	void advertiseTopic(const std::string& topicName);
 
+	/** Whether advertiseTopic() was already called for this topic */
+	bool isTopicAdvertised(const std::string& topicName) const;
+
 	void publishTopic(
 		const std::string& topicName, const google::protobuf::Message& msg);
 
@@ -92,6 +95,16 @@ class Client : public mrpt::system::COutputLogger
 	std::string callService(
 		const std::string& serviceName, const std::string& inputSerializedMsg);
 
+	/** Maximum time to wait for the answer of a service call, or <=0 to
+	 * wait forever (default). After a timeout, callService() throws, and the
+	 * next call looks up the service again, in case it was re-advertised
+	 * elsewhere. */
+	void setServiceCallTimeout(double seconds)
+	{
+		serviceCallTimeout_ = seconds;
+	}
+	double getServiceCallTimeout() const { return serviceCallTimeout_; }
+
 	struct InfoPerNode
 	{
 		std::string name;
@@ -114,6 +127,7 @@ class Client : public mrpt::system::COutputLogger
 
 	std::string serverHostAddress_ = "localhost";
 	std::string nodeName_ = "anonymous";
+	std::atomic<double> serviceCallTimeout_ = 0;  //!< [s], <=0: none
 
 	std::thread serviceInvokerThread_;
 	std::thread topicUpdatesThread_;
@@ -18,6 +18,7 @@
 #endif
 
 #include <iostream>
+#include <map>
 #include <mutex>
 #include <shared_mutex>
 
@@ -60,6 +61,10 @@ struct InfoPerAdvertisedTopic
 	zmq::socket_t pubSocket = zmq::socket_t(context, ZMQ_PUB);
 	std::string endpoint;
 	const google::protobuf::Descriptor* descriptor = nullptr;
+
+	/** Scratch buffers for publishTopic(), kept between messages */
+	std::string serializedMsg;
+	mrpt::io::CMemoryStream sendBuf;
 };
 
 struct InfoPerService
@@ -89,6 +94,18 @@ struct InfoPerSubscribedTopic
 
 	std::thread topicThread;
 };
+
+/** A connection to the node offering a service, reused across calls */
+struct ServiceReqSocket
+{
+	ServiceReqSocket(zmq::context_t& c) : socket(c, ZMQ_REQ) {}
+
+	zmq::socket_t socket;
+	/** REQ sockets must be used by one thread at a time */
+	std::mutex mtx;
+	/** Set (within mtx) once evicted from the cache after an error */
+	bool evicted = false;
+};
 }  // namespace mvsim::internal
 #endif
 
@@ -112,6 +129,11 @@ struct Client::ZMQImpl
 	std::optional<zmq::socket_t> topicNotificationsSocket;
 	std::string topicNotificationsEndPoint;
 
+	// Connections to the nodes offering services, reused across calls:
+	std::map<std::string, std::shared_ptr<internal::ServiceReqSocket>>
+		serviceReqSockets;
+	std::mutex serviceReqSockets_mtx;
+
 #endif
 };
 
@@ -227,6 +249,10 @@ void Client::shutdown() noexcept
 
 	if (serviceInvokerThread_.joinable()) serviceInvokerThread_.join();
 	if (topicUpdatesThread_.joinable()) topicUpdatesThread_.join();
+	{
+		std::lock_guard<std::mutex> lck(zmq_->serviceReqSockets_mtx);
+		zmq_->serviceReqSockets.clear();
+	}
 	zmq_->subscribedTopics.clear();
 	zmq_->offeredServices.clear();
 
@@ -476,6 +502,16 @@ void Client::doAdvertiseService(
 #endif
 }
 
+bool Client::isTopicAdvertised(const std::string& topicName) const
+{
+#if defined(MVSIM_HAS_ZMQ) && defined(MVSIM_HAS_PROTOBUF)
+	std::shared_lock<std::shared_mutex> lck(zmq_->advertisedTopics_mtx);
+	return zmq_->advertisedTopics.count(topicName) != 0;
+#else
+	return false;
+#endif
+}
+
 void Client::publishTopic(
 	const std::string& topicName, const google::protobuf::Message& msg)
 {
@@ -509,7 +545,20 @@ void Client::publishTopic(
 
 	ASSERT_(ipat.pubSocket.connected());
 
-	mvsim::sendMessage(msg, ipat.pubSocket);
+	// Same format as sendMessage(), but serialized into buffers kept between
+	// messages, which are only reallocated if messages grow:
+	msg.SerializeToString(&ipat.serializedMsg);
+	ipat.sendBuf.Seek(0);
+	auto arch = mrpt::serialization::archiveFrom(ipat.sendBuf);
+	arch << ipat.descriptor->full_name() << ipat.serializedMsg;
+
+	zmq::message_t m(
+		ipat.sendBuf.getRawBufferData(), ipat.sendBuf.getPosition());
+#if ZMQ_VERSION >= ZMQ_MAKE_VERSION(4, 3, 1)
+	ipat.pubSocket.send(m, zmq::send_flags::none);
+#else
+	ipat.pubSocket.send(m);
+#endif
 
 #if 0
 	MRPT_LOG_DEBUG_FMT(
@@ -711,39 +760,101 @@ void Client::doCallService(
 	MRPT_START
 #if defined(MVSIM_HAS_ZMQ) && defined(MVSIM_HAS_PROTOBUF)
 
-	// 1) Request to the server who is serving this service:
-	// TODO: Cache?
-	std::string srvEndpoint;
+	std::shared_ptr<internal::ServiceReqSocket> srv;
 	{
-		zmq::socket_t& s = *zmq_->mainReqSocket;
+		std::lock_guard<std::mutex> lck(zmq_->serviceReqSockets_mtx);
 
-		mvsim_msgs::GetServiceInfoRequest gsi;
-		gsi.set_servicename(serviceName);
-		mvsim::sendMessage(gsi, s);
+		auto& cached = zmq_->serviceReqSockets[serviceName];
+		if (!cached)
+		{
+			// 1) Request to the server who is serving this service:
+			std::string srvEndpoint;
+			zmq::socket_t& s = *zmq_->mainReqSocket;
 
-		auto m = mvsim::receiveMessage(s);
-		mvsim_msgs::GetServiceInfoAnswer gsia;
-		mvsim::parseMessage(m, gsia);
+			mvsim_msgs::GetServiceInfoRequest gsi;
+			gsi.set_servicename(serviceName);
+			mvsim::sendMessage(gsi, s);
 
-		if (!gsia.success())
-			THROW_EXCEPTION_FMT(
-				"Error requesting information about service `%s`: %s",
-				serviceName.c_str(), gsia.errormessage().c_str());
+			auto m = mvsim::receiveMessage(s);
+			mvsim_msgs::GetServiceInfoAnswer gsia;
+			mvsim::parseMessage(m, gsia);
 
-		srvEndpoint = gsia.serviceendpoint();
-	}
+			if (!gsia.success())
+			{
+				zmq_->serviceReqSockets.erase(serviceName);
+				THROW_EXCEPTION_FMT(
+					"Error requesting information about service `%s`: %s",
+					serviceName.c_str(), gsia.errormessage().c_str());
+			}
+
+			srvEndpoint = gsia.serviceendpoint();
 
-	// 2) Connect to the service offerrer and request the execution:
-	zmq::socket_t srvReqSock(zmq_->context, ZMQ_REQ);
-	srvReqSock.connect(srvEndpoint);
+			// 2) Connect to the service offerrer, once:
+			auto newSrv =
+				std::make_shared<internal::ServiceReqSocket>(zmq_->context);
+			newSrv->socket.setsockopt(ZMQ_LINGER, 0);
+			newSrv->socket.connect(srvEndpoint);
+			cached = std::move(newSrv);
+		}
+		srv = cached;
+	}
 
+	// Forgets the cached connection, e.g. if the service was re-advertised
+	// at another endpoint, so the next call looks it up again:
+	const auto evict = [&]() {
+		srv->evicted = true;
+		std::lock_guard<std::mutex> lck(zmq_->serviceReqSockets_mtx);
+		auto it = zmq_->serviceReqSockets.find(serviceName);
+		if (it != zmq_->serviceReqSockets.end() && it->second == srv)
+			zmq_->serviceReqSockets.erase(it);
+	};
+
+	// 3) Request the execution. Calls to other services do not wait for
+	// this one:
 	mvsim_msgs::CallService csMsg;
 	csMsg.set_servicename(serviceName);
 	csMsg.set_serializedinput(inputSerializedMsg);
 
-	mvsim::sendMessage(csMsg, srvReqSock);
+	std::unique_lock<std::mutex> srvLck(srv->mtx);
+	if (srv->evicted)
+	{
+		// Another call failed while we were waiting: start over.
+		srvLck.unlock();
+		doCallService(
+			serviceName, inputSerializedMsg, outputMsg, outputSerializedMsg,
+			outputMsgTypeName);
+		return;
+	}
+
+	zmq::message_t m;
+	bool received = false;
+	try
+	{
+		const double timeout = serviceCallTimeout_;
+		srv->socket.setsockopt(
+			ZMQ_RCVTIMEO,
+			timeout > 0 ? static_cast<int>(timeout * 1e3) : -1 /*forever*/);
+		mvsim::sendMessage(csMsg, srv->socket);
+#if ZMQ_VERSION >= ZMQ_MAKE_VERSION(4, 3, 1)
+		received = srv->socket.recv(m).has_value();
+#else
+		received = srv->socket.recv(&m);
+#endif
+	}
+	catch (...)
+	{
+		// The socket may be left in an invalid REQ state: reconnect next time
+		evict();
+		throw;
+	}
+	if (!received)
+	{
+		evict();
+		THROW_EXCEPTION_FMT(
+			"Timeout waiting for the answer of service `%s`",
+			serviceName.c_str());
+	}
 
-	const auto m = mvsim::receiveMessage(srvReqSock);
 	if (outputMsg)
 	{
 		mvsim::parseMessage(m, outputMsg.value().get());
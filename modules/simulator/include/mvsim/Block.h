@@ -45,9 +45,13 @@ class Block : public VisualObject, public Simulable
 	 * "<block:class name='name'>...</block:class>".  */
 	static void register_block_class(const rapidxml::xml_node<char>* xml_node);
 
+	/** Whether register_block_class() was called for class \a name */
+	static bool is_registered_class(const std::string& name);
+
 	// ------- Interface with "World" ------
 	virtual void simul_pre_timestep(const TSimulContext& context) override;
 	virtual void simul_post_timestep(const TSimulContext& context) override;
+	bool simul_is_parallel_safe() const override { return true; }
 	virtual void apply_force(
 		const mrpt::math::TVector2D& force,
 		const mrpt::math::TPoint2D& applyPoint =
@@ -79,6 +83,11 @@ class Block : public VisualObject, public Simulable
 		m_gl_block.reset();  // regenerate 3D view
 	}
 
+	/** Renames a block of class \a className removed by World::despawn(),
+	 * so it can be spawned again as a new instance, and re-parses the
+	 * settings which depend on its name (e.g. <publish>). */
+	void recycleAs(const std::string& name, const std::string& className);
+
 	/** Set the block index in the World */
 	void setBlockIndex(size_t idx) { m_block_index = idx; }
 	/** Get the block index in the World */
@@ -160,6 +169,14 @@ class Block : public VisualObject, public Simulable
    private:
 	void internal_internalGuiUpdate_forces(mrpt::opengl::COpenGLScene& scene);
 
+	/** Parses the visual model, params and shape from the instance node
+	 * \a root (if not nullptr) and/or its \a class_root (idem) */
+	void internal_parse_params(
+		const rapidxml::xml_node<char>* root,
+		const rapidxml::xml_node<char>* class_root);
+	/** Copies all that internal_parse_params() loads from another block */
+	void internal_copy_params(const Block& o);
+
 	mrpt::opengl::CSetOfObjects::Ptr m_gl_block;
 	mrpt::opengl::CSetOfLines::Ptr m_gl_forces;
 	std::mutex m_force_segments_for_rendering_cs;
@@ -11,6 +11,11 @@
 
 #include <mvsim/basic_types.h>
 
+namespace mrpt::serialization
+{
+class CArchive;
+}
+
 namespace mvsim
 {
 /** Interface of ControllerBaseTempl<> for teleoperation, etc.
@@ -39,6 +44,17 @@ class ControllerBaseInterface
 	{
 		return false; /* default: no */
 	}
+
+	/** Save/restore setpoints and any other internal state (e.g. PID
+	 * integrators). See World::saveState() */
+	virtual void saveState(
+		[[maybe_unused]] mrpt::serialization::CArchive& out) const
+	{ /*default: do nothing*/
+	}
+	virtual void restoreState(
+		[[maybe_unused]] mrpt::serialization::CArchive& in)
+	{ /*default: do nothing*/
+	}
 };
 
 /** Virtual base for controllers of vehicles of any type (template) */
@@ -1,37 +1,66 @@
 #pragma once
 
+#include <mvsim/TelemetryLog.h>
+
+#include <atomic>
 #include <fstream>
-#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 class CSVLogger
 {
-	typedef std::map<std::string, double> columns_type;
-
    public:
+	/** Index of a column, as returned by addColumn() */
+	typedef size_t column_t;
+
 	CSVLogger();
 	virtual ~CSVLogger();
 
    public:
-	void addColumn(std::string name);
-	void updateColumn(std::string name, double value);
+	/** Registers a new column (or returns the existing one with the same
+	 * name). Columns are written in the order they were added. */
+	column_t addColumn(const std::string& name);
+
+	/** Sets the value of a column in the current row. Callers should skip
+	 * computing values when isRecording() is false. */
+	void updateColumn(column_t column, double value)
+	{
+		m_values[column] = value;
+	}
+
 	bool writeHeader();
 	bool writeRow();
 
+	/** File formats. Binary files are written from a background thread; see
+	 * mvsim::TelemetryWriter for their structure. */
+	enum class Format
+	{
+		CSV = 0,
+		Binary
+	};
+
+	/** Must be set before the file is open */
+	void setFormat(Format f) { m_format = f; }
+	Format getFormat() const { return m_format; }
+
 	void setFilepath(std::string path) { m_filepath = path; }
 	bool open();
 	bool isOpen();
 	bool close();
 	bool clear();
 
-	void setRecording(bool recording) { isRecording = recording; }
+	void setRecording(bool recording) { m_recording = recording; }
+	bool isRecording() const { return m_recording; }
 	void newSession();
 
    private:
-	columns_type m_columns;
+	std::vector<std::string> m_names;
+	std::vector<double> m_values;  //!< Current row, same size as m_names
 	std::shared_ptr<std::ofstream> m_file;
+	Format m_format = Format::CSV;
+	std::unique_ptr<mvsim::TelemetryWriter> m_binary_file;
 	std::string m_filepath;
-	bool isRecording = false;
+	std::atomic_bool m_recording = false;
 	unsigned int currentSession = 1;
 };
@@ -32,6 +32,8 @@ class DefaultFriction : public FrictionBase
 		const FrictionBase::TFrictionInput& input,
 		mrpt::math::TPoint2D& out_result_force_local) const override;
 
+	bool getBatchParams(FrictionBatchParams& p) const override;
+
    private:
 	double m_mu;  //!< friction coeficient (non-dimensional)
 	double m_C_damping;	 //!< For wheels "internal friction" (N*m*s/rad)
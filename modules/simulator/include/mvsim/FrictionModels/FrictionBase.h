@@ -11,6 +11,7 @@
 
 #include <mvsim/ClassFactory.h>
 #include <mvsim/CsvLogger.h>
+#include <mvsim/FrictionModels/FrictionBatch.h>
 #include <mvsim/Wheel.h>
 #include <mvsim/basic_types.h>  // fwrd decls.
 
@@ -59,13 +60,36 @@ class FrictionBase
 		const FrictionBase::TFrictionInput& input,
 		mrpt::math::TPoint2D& out_result_force_local) const = 0;
 
-	void setLogger(const std::weak_ptr<CSVLogger>& logger);
+	/** Registers the columns written by evaluate_friction() into a wheel
+	 * logger. Called once for each wheel: all wheel loggers have the same
+	 * columns, so handles are valid for any of them. */
+	virtual void registerLogColumns([[maybe_unused]] CSVLogger& logger) {}
+
+	/** Sets the logger of the wheel for the next evaluate_friction() call,
+	 * or nullptr if it is not recording. */
+	void setLogger(CSVLogger* logger) { m_logger = logger; }
+
+	/** If this model can be evaluated by FrictionBatch, fills in its
+	 * parameters and returns true. Otherwise (the default), the World calls
+	 * evaluate_friction() for each wheel. */
+	virtual bool getBatchParams([[maybe_unused]] FrictionBatchParams& p) const
+	{
+		return false;
+	}
+
+	/** Like the log columns written by evaluate_friction(), for wheel \a i
+	 * of an already evaluated FrictionBatch. */
+	virtual void logBatchOutputs(
+		[[maybe_unused]] CSVLogger& logger,
+		[[maybe_unused]] const FrictionBatch& b, [[maybe_unused]] size_t i) const
+	{
+	}
 
    protected:
 	World* m_world;
 	VehicleBase& m_my_vehicle;
 
-	std::weak_ptr<CSVLogger> m_logger;
+	CSVLogger* m_logger = nullptr;
 };
 
 typedef std::shared_ptr<FrictionBase> FrictionBasePtr;
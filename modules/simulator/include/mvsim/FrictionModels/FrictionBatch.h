@@ -0,0 +1,72 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace mvsim
+{
+/** Parameters of a friction model that can be evaluated in batches, see
+ * FrictionBase::getBatchParams() */
+struct FrictionBatchParams
+{
+	double mu = 0.8;  //!< friction coeficient (non-dimensional)
+	double C_damping = 1.0;	 //!< Wheels "internal friction" (N*m*s/rad)
+	/** Ward-Iagnemma rolling resistance coefficients. Use R1=R2=0 for no
+	 * rolling resistance (DefaultFriction). */
+	double A_roll = 0, R1 = 0, R2 = 0;
+
+	bool hasRollingResistance() const { return R1 != 0 || R2 != 0; }
+};
+
+/** Structure-of-arrays inputs and outputs of friction forces for many
+ * wheels (typically, all wheels in the World), so they are evaluated in
+ * tight, vectorizable loops instead of one virtual call per wheel.
+ *
+ * Wheels with rolling resistance must come first (indices below
+ * numRollingResistance), so the rest skip its (costly) evaluation.
+ *
+ * All vectors have size(): use resize(). Vehicles fill in the inputs of
+ * their own wheels, which may be done in parallel for different vehicles.
+ */
+struct FrictionBatch
+{
+	// Inputs:
+	std::vector<double> vel_x, vel_y;  //!< Wheel velocity, vehicle frame
+	std::vector<double> cos_yaw, sin_yaw;  //!< Wheel orientation, vehicle
+	std::vector<double> torque;	 //!< Motor torque (Nm), <0 is forwards
+	std::vector<double> weight;	 //!< Weight of the chassis on the wheel (N)
+	std::vector<double> mass, Iyy, radius;	//!< Wheel parameters
+	std::vector<double> mu, C_damping, A_roll, R1, R2;	//!< See params
+	/** Wheel spinning velocity (rad/s): input and output */
+	std::vector<double> w;
+	/** Time the forces are applied for (s): the timestep, or longer for
+	 * vehicles with a lower level of detail (see World::TLODOptions) */
+	std::vector<double> dt;
+
+	// Outputs:
+	std::vector<double> force_x, force_y;  //!< Net force, vehicle frame (N)
+	std::vector<double> F_rr;  //!< Rolling resistance (N)
+
+	size_t numRollingResistance = 0;
+
+	size_t size() const { return w.size(); }
+	void resize(size_t n);
+
+	/** Sets the model parameters of wheel \a i */
+	void setParams(size_t i, const FrictionBatchParams& p);
+
+	/** Evaluates wheels \a first to \a last-1, updating w[] and the
+	 * outputs. The inputs of other wheels are not read. */
+	void evaluate(double gravity, size_t first, size_t last);
+};
+
+}  // namespace mvsim
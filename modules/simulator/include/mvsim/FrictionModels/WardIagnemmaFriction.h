@@ -34,10 +34,18 @@ class WardIagnemmaFriction : public FrictionBase
 		const FrictionBase::TFrictionInput& input,
 		mrpt::math::TPoint2D& out_result_force_local) const override;
 
+	void registerLogColumns(CSVLogger& logger) override;
+
+	bool getBatchParams(FrictionBatchParams& p) const override;
+	void logBatchOutputs(
+		CSVLogger& logger, const FrictionBatch& b, size_t i) const override;
+
    private:
 	double m_mu;  //!< friction coeficient (non-dimensional)
 	double m_C_damping;	 //!< For wheels "internal friction" (N*m*s/rad)
 	double m_A_roll, m_R1,
 		m_R2;  //!< Ward-Iagnemma rolling resistance coefficient
+
+	CSVLogger::column_t m_col_F_rr = 0;
 };
 }  // namespace mvsim
@@ -0,0 +1,81 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace mvsim
+{
+/** Unbounded, lock-free, multiple-producer single-consumer FIFO queue.
+ *
+ * push() may be called concurrently from any number of threads, while
+ * pop() must be only called from one (consumer) thread. Based on the
+ * algorithm by Dmitry Vyukov: producers never wait for each other nor for
+ * the consumer, beyond one atomic exchange.
+ */
+template <typename T>
+class MPSCQueue
+{
+   public:
+	MPSCQueue() : m_head(new Node()), m_tail(m_head.load()) {}
+
+	~MPSCQueue()
+	{
+		T tmp;
+		while (pop(tmp))
+		{
+		}
+		delete m_tail;
+	}
+
+	MPSCQueue(const MPSCQueue&) = delete;
+	MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+	/** Enqueues an element. Thread-safe. */
+	void push(T&& value)
+	{
+		Node* n = new Node(std::move(value));
+		Node* prev = m_head.exchange(n, std::memory_order_acq_rel);
+		prev->next.store(n, std::memory_order_release);
+	}
+
+	/** Dequeues the oldest element, if any. Only from the consumer thread.
+	 * \return false if the queue was empty, or the only pending push() has
+	 * not finished yet. */
+	bool pop(T& out)
+	{
+		Node* tail = m_tail;
+		Node* next = tail->next.load(std::memory_order_acquire);
+		if (!next) return false;
+
+		// "next" becomes the new dummy node:
+		out = std::move(next->value);
+		m_tail = next;
+		delete tail;
+		return true;
+	}
+
+   private:
+	struct Node
+	{
+		Node() = default;
+		explicit Node(T&& v) : value(std::move(v)) {}
+
+		std::atomic<Node*> next = nullptr;
+		T value{};
+	};
+
+	/** Last pushed node (producers side) */
+	std::atomic<Node*> m_head;
+	/** Dummy node before the oldest element (consumer side) */
+	Node* m_tail;
+};
+}  // namespace mvsim
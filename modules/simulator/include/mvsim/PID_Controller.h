@@ -8,6 +8,11 @@
   +-------------------------------------------------------------------------+ */
 #pragma once
 
+namespace mrpt::serialization
+{
+class CArchive;
+}
+
 namespace mvsim
 {
 struct PID_Controller
@@ -20,6 +25,11 @@ struct PID_Controller
 	/** err = desired-actual, dt=ellapsed time in secs */
 	double compute(double err, double dt);
 
+	/** Save/restore the internal state (not the gains). See
+	 * World::saveState() */
+	void saveState(mrpt::serialization::CArchive& out) const;
+	void restoreState(mrpt::serialization::CArchive& in);
+
    private:
 	double lastOutput;
 	double e_n, e_n_1, e_n_2;
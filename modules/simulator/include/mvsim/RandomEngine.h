@@ -0,0 +1,51 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace mvsim
+{
+/** Small random engine (SplitMix64) whose whole state is one 64-bit word,
+ * so it can be saved and restored by just copying it (see
+ * World::saveState()). Meets the UniformRandomBitGenerator requirements, so
+ * it can be used with the <random> distributions.
+ */
+class RandomEngine
+{
+   public:
+	using result_type = uint64_t;
+
+	explicit RandomEngine(uint64_t seed = 0) : m_state(seed) {}
+
+	void seed(uint64_t seed) { m_state = seed; }
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max()
+	{
+		return std::numeric_limits<result_type>::max();
+	}
+
+	result_type operator()()
+	{
+		uint64_t z = (m_state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	uint64_t state() const { return m_state; }
+	void setState(uint64_t state) { m_state = state; }
+
+   private:
+	uint64_t m_state;
+};
+}  // namespace mvsim
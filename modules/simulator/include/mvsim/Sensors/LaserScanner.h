@@ -9,15 +9,23 @@
 
 #pragma once
 
+#include <mrpt/core/Clock.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/opengl/CPlanarLaserScan.h>
 #include <mrpt/poses/CPose2D.h>
+#include <mvsim/RandomEngine.h>
+#include <mvsim/Sensors/ObservationPool.h>
 #include <mvsim/Sensors/SensorBase.h>
 
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace mvsim
 {
+class OccupancyGridMap;
+class ScanRayCaster;
+
 class LaserScanner : public SensorBase
 {
 	DECLARES_REGISTER_SENSOR(LaserScanner)
@@ -29,15 +37,21 @@ class LaserScanner : public SensorBase
 	virtual void loadConfigFrom(const rapidxml::xml_node<char>* root) override;
 
 	virtual void simul_pre_timestep(const TSimulContext& context) override;
-	virtual void simul_post_timestep(const TSimulContext& context) override;
+	void simul_post_timestep_commit(const TSimulContext& context) override;
 
 	void poses_mutex_lock() override {}
 	void poses_mutex_unlock() override {}
 
+	void saveState(mrpt::serialization::CArchive& out) const override;
+	void restoreState(mrpt::serialization::CArchive& in) override;
+
    protected:
 	virtual void internalGuiUpdate(
 		mrpt::opengl::COpenGLScene& scene, bool childrenOnly) override;
 
+	void simul_sensor_snapshot(const TSimulContext& context) override;
+	void simul_sensor_compute(const TSimulContext& context) override;
+
 	int m_z_order;  //!< to help rendering multiple scans
 	mrpt::poses::CPose2D m_sensor_pose_on_veh;
 	std::string m_name;  //!< sensor label/name
@@ -47,6 +61,10 @@ class LaserScanner : public SensorBase
 	 */
 	bool m_see_fixtures;
 
+	/** Private random generator for sensor noise (repeatible, and no
+	 * contention with other threads or worlds) */
+	RandomEngine m_rnd;
+
 	bool m_viz_visiblePlane = false;
 	bool m_viz_visiblePoints = false;
 	float m_viz_pointSize = 3.0f;
@@ -55,6 +73,28 @@ class LaserScanner : public SensorBase
 	// "pattern" to fill it with actual scan data.
 	mrpt::obs::CObservation2DRangeScan m_scan_model;
 
+	/** cos() and sin() of the angle of each ray, relative to the sensor
+	 * heading. Set in loadConfigFrom() */
+	std::vector<double> m_ray_cos, m_ray_sin;
+	/** Ray directions (global coordinates) and ranges, for each scan */
+	std::vector<double> m_ray_dx, m_ray_dy, m_ray_range;
+	/** Fixtures near the sensor, gathered in simul_sensor_snapshot() */
+	std::unique_ptr<ScanRayCaster> m_ray_caster;
+
+	/** The rest of the snapshot: sensor pose (global coordinates), wall
+	 * clock time, and grid maps to ray trace */
+	mrpt::poses::CPose2D m_snapshot_pose;
+	mrpt::Clock::time_point m_snapshot_time;
+	std::vector<const OccupancyGridMap*> m_snapshot_grids;
+
+	/** Time spent on the last scan [seconds], by kind of world object */
+	double m_time_gridmap = 0, m_time_polygons = 0;
+
+	/** Scans to be reused, see simul_sensor_compute() */
+	ObservationPool<mrpt::obs::CObservation2DRangeScan> m_obs_pool;
+
+	/** Protects the hand-off of scans to the GUI: m_last_scan,
+	 * m_last_scan2gui and m_gui_uptodate */
 	std::mutex m_last_scan_cs;
 	/** Last simulated scan */
 	mrpt::obs::CObservation2DRangeScan::Ptr m_last_scan;
@@ -63,7 +103,7 @@ class LaserScanner : public SensorBase
 	/** Whether m_gl_scan has to be updated upon next call of
 	 * internalGuiUpdate() from m_last_scan2gui */
 	bool m_gui_uptodate = false;
-	std::mutex m_gui_mtx;
+	std::mutex m_gui_mtx;  //!< Protects m_gl_scan
 	mrpt::opengl::CPlanarLaserScan::Ptr m_gl_scan;
 };
 }  // namespace mvsim
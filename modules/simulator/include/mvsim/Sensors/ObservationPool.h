@@ -0,0 +1,72 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace mvsim
+{
+/** A small pool of sensor observations, so each reading reuses the memory
+ * of a former one (e.g. the range arrays of a scan) instead of allocating
+ * a new observation.
+ *
+ * An observation is reused once all its consumers (the GUI, publishers,
+ * World::onNewObservation(), ...) have released their shared_ptr to it,
+ * that is, when the pool holds the only reference. Each sensor owns its
+ * pool, and calls acquire() from a single thread at a time.
+ */
+template <class OBS>
+class ObservationPool
+{
+   public:
+	using Ptr = std::shared_ptr<OBS>;
+
+	/** \param[in] maxSize Beyond this number of observations in use, new
+	 * ones are not kept in the pool. */
+	explicit ObservationPool(size_t maxSize = 8) : m_max_size(maxSize) {}
+
+	/** Returns an observation that nobody else holds, with the contents of
+	 * its last use. */
+	Ptr acquire()
+	{
+		// Oldest first, giving consumers the longest time to release them:
+		for (size_t k = 0; k < m_items.size(); k++)
+		{
+			const Ptr& o = m_items[m_next];
+			m_next = (m_next + 1) % m_items.size();
+			if (o.use_count() != 1) continue;
+
+			// Consumers in other threads are done with its contents:
+			std::atomic_thread_fence(std::memory_order_acquire);
+			return o;
+		}
+
+		// All in use:
+		auto o = std::make_shared<OBS>();
+		if (m_items.size() < m_max_size)
+		{
+			m_items.insert(m_items.begin() + m_next, o);
+			m_next = (m_next + 1) % m_items.size();
+		}
+		return o;
+	}
+
+	/** Number of observations kept in the pool */
+	size_t size() const { return m_items.size(); }
+
+   private:
+	std::vector<Ptr> m_items;
+	size_t m_next = 0;  //!< Next one to try, the oldest in use
+	const size_t m_max_size;
+};
+
+}  // namespace mvsim
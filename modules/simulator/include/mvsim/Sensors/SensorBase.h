@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <mrpt/io/CMemoryStream.h>
 #include <mrpt/obs/obs_frwds.h>
 #include <mvsim/ClassFactory.h>
 #include <mvsim/Simulable.h>
@@ -39,6 +40,18 @@ class SensorBase : public VisualObject, public Simulable
 
 	void registerOnServer(mvsim::Client& c) override;
 
+	/** Registers the sensor to run every m_sensor_period as a parallel
+	 * periodic task: simul_sensor_snapshot(), simul_sensor_compute() and
+	 * simul_post_timestep_commit(), which must report the observation. See
+	 * TaskScheduler::add_parallel() */
+	void registerPeriodicTasks(TaskScheduler& scheduler) override;
+
+	/** Runs simul_sensor_snapshot() and simul_sensor_compute() at once */
+	void simul_post_timestep(const TSimulContext& context) override;
+
+	void saveState(mrpt::serialization::CArchive& out) const override;
+	void restoreState(mrpt::serialization::CArchive& in) override;
+
    protected:
 	VehicleBase& m_vehicle;  //!< The vehicle this sensor is attached to
 
@@ -47,6 +60,14 @@ class SensorBase : public VisualObject, public Simulable
 
 	std::string publishTopic_;
 
+	/** Scratch buffer to serialize observations, see reportNewObservation()
+	 */
+	mrpt::io::CMemoryStream m_serialization_buf;
+
+	/** Message reused by reportNewObservation() to publish observations */
+	struct PublishMsg;
+	std::unique_ptr<PublishMsg> m_publish_msg;
+
 	bool parseSensorPublish(
 		const rapidxml::xml_node<char>* node,
 		const std::map<std::string, std::string>& varValues);
@@ -54,6 +75,20 @@ class SensorBase : public VisualObject, public Simulable
 	void reportNewObservation(
 		const std::shared_ptr<mrpt::obs::CObservation>& obs,
 		const TSimulContext& context);
+
+	/** Copies from the world whatever simul_sensor_compute() needs (e.g. the
+	 * sensor pose, nearby geometry), since it may run while the next timestep
+	 * modifies the world (see World::m_sensors_pipelined). It may run at the
+	 * same time as other sensors, so it must only read the world. */
+	virtual void simul_sensor_snapshot(
+		[[maybe_unused]] const TSimulContext& context)
+	{
+	}
+
+	/** Simulates a reading from the last snapshot only, modifying nothing but
+	 * the sensor own state. The rest of the work (e.g.
+	 * reportNewObservation()) goes to simul_post_timestep_commit(). */
+	virtual void simul_sensor_compute(const TSimulContext& context) = 0;
 };
 
 // Class factory:
@@ -15,11 +15,20 @@
 #include <mrpt/poses/CPose2D.h>
 #include <mvsim/basic_types.h>
 
+#include <atomic>
 #include <shared_mutex>
+#include <utility>
+#include <vector>
+
+namespace mrpt::serialization
+{
+class CArchive;
+}
 
 namespace mvsim
 {
 class Client;
+class TaskScheduler;
 
 class Simulable
 {
@@ -27,16 +36,78 @@ class Simulable
 	using Ptr = std::shared_ptr<Simulable>;
 
 	/** Process right before the integration of dynamic equations for each
-	 * timestep: set action forces from motors, update friction models, etc. */
+	 * timestep: set action forces from motors, update friction models, etc.
+	 * If simul_is_parallel_safe() returns true, this may be invoked from a
+	 * worker thread, concurrently with other objects, so Box2D forces must
+	 * be queued with queueForce() instead of applied directly.
+	 */
 	virtual void simul_pre_timestep(const TSimulContext& context);
 
 	/** Override to do any required process right after the integration of
 	 * dynamic equations for each timestep.
 	 * IMPORTANT: Reimplementations MUST also call this base method,
 	 * since it is in charge of important tasks (e.g. update m_q, m_dq)
+	 * The same threading rules as in simul_pre_timestep() apply.
 	 */
 	virtual void simul_post_timestep(const TSimulContext& context);
 
+	/** Writes the current pose and twist (m_q, m_dq) into the Box2D body, if
+	 * they were changed with setPose() or setTwist() since the last call.
+	 * Invoked by World sequentially for all objects before any
+	 * simul_pre_timestep(), since it modifies the b2World broad-phase.
+	 * \return true if the body was modified */
+	bool simul_sync_b2d_body();
+
+	/** Whether World can skip the per-timestep hooks of this object in the
+	 * next timestep, because it is passive (see simul_is_passive()) and its
+	 * body is static or asleep, or because it is batched (see
+	 * simul_is_batched()). */
+	bool simul_is_idle() const;
+
+	/** Whether World steps this object as part of a batch of objects of the
+	 * same kind, instead of calling its per-timestep hooks (e.g.
+	 * DynamicsKinematicLite). */
+	virtual bool simul_is_batched() const { return false; }
+
+	/** Whether this object only moves as a result of Box2D dynamics (e.g. it
+	 * has no motors), so it may be left alone while its body sleeps.
+	 * Objects with actuators must return false, since they are responsible
+	 * for waking up their bodies. */
+	virtual bool simul_is_passive() const { return true; }
+
+	/** Invoked by World sequentially, in a fixed order, after all objects
+	 * ran simul_pre_timestep(): applies the forces queued with queueForce()
+	 * in the same order they were queued. If \a hold, they are also kept,
+	 * in body coordinates, for simul_pre_timestep_recommit(). */
+	void simul_pre_timestep_commit(bool hold = false);
+
+	/** Invoked by World instead of simul_pre_timestep_commit() in timesteps
+	 * in which it skipped simul_pre_timestep() (see World::TLODOptions):
+	 * applies again the forces held by the last commit, which turn along
+	 * with the body. */
+	void simul_pre_timestep_recommit();
+
+	/** Invoked by World sequentially, in a fixed order, after all objects
+	 * ran simul_post_timestep(). Work that is not thread-safe must be done
+	 * here, or in a periodic task (see registerPeriodicTasks()).
+	 * IMPORTANT: Reimplementations MUST also call this base method.
+	 */
+	virtual void simul_post_timestep_commit(const TSimulContext& context);
+
+	/** Invoked by World to register the tasks this object needs to run at a
+	 * fixed rate (e.g. sensor readings, publishing to topics). They are run
+	 * after all simul_post_timestep_commit(), only at the timesteps they are
+	 * due: first the parallel ones, then the rest sequentially (see
+	 * TaskScheduler::run_due_tasks()).
+	 * IMPORTANT: Reimplementations MUST also call this base method.
+	 */
+	virtual void registerPeriodicTasks(TaskScheduler& scheduler);
+
+	/** Whether simul_pre_timestep() and simul_post_timestep() only modify
+	 * this object state (apart from queued forces), so World may run them
+	 * in parallel with other objects. See `<simul_threads>`. */
+	virtual bool simul_is_parallel_safe() const { return false; }
+
 	virtual void poses_mutex_lock() = 0;
 	virtual void poses_mutex_unlock() = 0;
 
@@ -74,6 +145,20 @@ class Simulable
 	{
 		m_q_mtx.lock();
 		const_cast<mrpt::math::TPose3D&>(m_q) = p;
+		m_q_version++;
+		m_q_mtx.unlock();
+	}
+
+	/** Sets the pose components not simulated by Box2D (z, pitch, roll),
+	 * e.g. from terrain elevation. Unlike setPose(), this does not make the
+	 * pose to be written back into Box2D (see simul_sync_b2d_body()) */
+	void setPoseOutOfPlane(double z, double pitch, double roll) const
+	{
+		m_q_mtx.lock();
+		auto& q = const_cast<mrpt::math::TPose3D&>(m_q);
+		q.z = z;
+		q.pitch = pitch;
+		q.roll = roll;
 		m_q_mtx.unlock();
 	}
 
@@ -81,6 +166,7 @@ class Simulable
 	{
 		m_q_mtx.lock();
 		const_cast<mrpt::math::TTwist2D&>(m_dq) = dq;
+		m_q_version++;
 		m_q_mtx.unlock();
 	}
 
@@ -110,6 +196,16 @@ class Simulable
 
 	virtual void registerOnServer(mvsim::Client& c);
 
+	/** Writes the dynamic state of this object (pose, twist, etc.) for
+	 * World::saveState().
+	 * IMPORTANT: Reimplementations MUST also call this base method. */
+	virtual void saveState(mrpt::serialization::CArchive& out) const;
+
+	/** Reads back a state written by saveState(). The new pose is written
+	 * into Box2D before the next timestep.
+	 * IMPORTANT: Reimplementations MUST also call this base method. */
+	virtual void restoreState(mrpt::serialization::CArchive& in);
+
 	const b2Body* b2d_body() const { return m_b2d_body; }
 	b2Body* b2d_body() { return m_b2d_body; }
 
@@ -126,6 +222,13 @@ class Simulable
 
 	bool parseSimulable(const rapidxml::xml_node<char>* node);
 
+	/** Queues a force (in global coordinates) to be applied to m_b2d_body at
+	 * the given global point in simul_pre_timestep_commit(). */
+	void queueForce(const b2Vec2& force, const b2Vec2& point)
+	{
+		m_queued_forces.emplace_back(force, point);
+	}
+
 	void internalHandlePublish(const TSimulContext& context);
 
    private:
@@ -138,6 +241,13 @@ class Simulable
 	/** Last time-step velocity (of the ref. point, in global coords) */
 	mrpt::math::TTwist2D m_dq{0, 0, 0};
 
+	/** Incremented each time m_q or m_dq are changed from outside of the
+	 * simulation (setPose(), setTwist(), restoreState()) */
+	mutable std::atomic<uint64_t> m_q_version{0};
+
+	/** Value of m_q_version last written into the Box2D body */
+	uint64_t m_q_synced_version = 0;
+
 	/** Whether is is in collision right now */
 	bool m_isInCollision = false;
 
@@ -147,7 +257,14 @@ class Simulable
 
 	/** If not empty, publish the pose on this topic */
 	std::string publishPoseTopic_;
-	double publishPosePeriod_ = 100e-3;	 //! Publish period [seconds]
-	double publishPoseLastTime_ = 0;
+	/** Publish period [seconds], in simulated time */
+	double publishPosePeriod_ = 100e-3;
+
+	/** Pairs (force, application point) in global coordinates, see
+	 * queueForce() */
+	std::vector<std::pair<b2Vec2, b2Vec2>> m_queued_forces;
+	/** Same pairs, in body coordinates, held by the last
+	 * simul_pre_timestep_commit() */
+	std::vector<std::pair<b2Vec2, b2Vec2>> m_held_forces;
 };
 }  // namespace mvsim
@@ -0,0 +1,120 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mvsim
+{
+/** Optional profiler of the time spent by each object in each phase of a
+ * simulation timestep, to find out which vehicles, sensors or world elements
+ * are responsible for slow timesteps. Owned by World, see
+ * World::getProfilerReport().
+ *
+ * Measurements are identified by their phase and an index: the object
+ * handle (see World::ObjectHandle) or, for periodic tasks, the task index in
+ * the TaskScheduler.
+ *
+ * While disabled, measure() only adds the cost of checking a flag.
+ */
+class SimulableProfiler
+{
+   public:
+	enum class Phase : uint8_t
+	{
+		PreStep = 0,
+		PostStep,
+		PeriodicTask,
+		GuiUpdate
+	};
+	static constexpr size_t PHASE_COUNT = 4;
+
+	static const char* phaseName(Phase p);
+
+	struct Stats
+	{
+		uint64_t count = 0;
+		double total = 0;  //!< [seconds]
+		double max = 0;	 //!< [seconds]
+
+		double mean() const { return count ? total / count : .0; }
+	};
+
+	struct Entry
+	{
+		std::string name;
+		Phase phase = Phase::PreStep;
+		Stats stats;
+	};
+
+	void enable(bool enabled = true) { m_enabled = enabled; }
+	bool isEnabled() const { return m_enabled; }
+
+	/** Discards all measurements */
+	void clear();
+
+	/** Discards the measurements of one phase only */
+	void clear(Phase phase);
+
+	/** Discards the measurements of the object with this index, e.g. when
+	 * it is reused by another object */
+	void clearObject(size_t index);
+
+	/** Makes room for measurements of all objects and periodic tasks. Must
+	 * be called from the simulation thread before each timestep. */
+	void prepare(size_t numObjects, size_t numTasks);
+
+	/** Runs f() and, if enabled, accumulates its execution time.
+	 * Calls for different indices may run in parallel, except for
+	 * Phase::GuiUpdate, which is expected from the GUI thread only.
+	 */
+	template <class FUNCTOR>
+	void measure(Phase phase, size_t index, FUNCTOR&& f)
+	{
+		if (!m_enabled)
+		{
+			f();
+			return;
+		}
+
+		const auto t0 = std::chrono::steady_clock::now();
+		f();
+		const std::chrono::duration<double> dt =
+			std::chrono::steady_clock::now() - t0;
+
+		add(phase, index, dt.count());
+	}
+
+	/** Returns the \a n entries with the largest total time, in decreasing
+	 * order. \a nameOf must return the name of the object or task for
+	 * a given phase and index (or an empty string if it no longer exists).
+	 */
+	std::vector<Entry> getTopN(
+		size_t n,
+		const std::function<std::string(Phase, size_t)>& nameOf) const;
+
+   private:
+	std::atomic_bool m_enabled = false;
+
+	std::array<std::vector<Stats>, PHASE_COUNT> m_stats;
+
+	/** Protects m_stats[GuiUpdate], which is resized from the GUI thread */
+	mutable std::mutex m_gui_mtx;
+
+	void add(Phase phase, size_t index, double dt);
+};
+}  // namespace mvsim
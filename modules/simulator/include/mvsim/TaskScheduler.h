@@ -0,0 +1,158 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <mvsim/SimulableProfiler.h>
+#include <mvsim/basic_types.h>
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace mvsim
+{
+/** Runs periodic tasks (sensor readings, topic publishing, etc.) at their
+ * own rate, in multiples of the simulation timestep.
+ *
+ * Tasks are kept in a hashed timing wheel: one slot per timestep, modulo the
+ * wheel size. Each call to run_due_tasks() only visits the tasks in the
+ * current slot, so objects with long periods cost nothing in the steps where
+ * they are not due.
+ *
+ * Owned by World, which rebuilds it whenever its contents change. Not
+ * thread-safe.
+ */
+class TaskScheduler
+{
+   public:
+	using task_t = std::function<void(const TSimulContext&)>;
+
+	/** Runs f(i) for i=0...n-1, possibly in parallel, and returns once all
+	 * of them have ended */
+	using parallel_for_t =
+		std::function<void(size_t n, const std::function<void(size_t)>& f)>;
+
+	/** Starts f() in a background thread */
+	using enqueue_t =
+		std::function<std::future<void>(const std::function<void()>& f)>;
+
+	TaskScheduler();
+
+	/** Removes all tasks, after waiting for pipelined ones (see
+	 * wait_pipelined()).
+	 * \param[in] dt Simulation timestep [seconds]
+	 * \param[in] simul_time Simulation time of the next call to
+	 * run_due_tasks() [seconds]
+	 */
+	void clear(double dt, double simul_time);
+
+	/** Registers a task to be run every \a period seconds of simulated time,
+	 * rounded up to a multiple of the timestep, the first time at (or right
+	 * after) \a first_time. Times in the past mean "in the next step".
+	 * \param[in] name Used to identify the task in profiler reports.
+	 */
+	void add(
+		double period, double first_time, const task_t& task,
+		const std::string& name = std::string());
+
+	/** Like add(), for tasks split into a \a snapshot of whatever they need
+	 * from the world, a \a compute that only uses that snapshot and their
+	 * own state, and a \a commit (may be empty) for the rest of the work
+	 * (e.g. publishing). \a snapshot and \a compute may run at the same
+	 * time as those of other parallel tasks due at the same step, so they
+	 * must not modify anything shared with them. \a commit always runs in
+	 * the simulation thread.
+	 */
+	void add_parallel(
+		double period, double first_time, const task_t& snapshot,
+		const task_t& compute, const task_t& commit,
+		const std::string& name = std::string());
+
+	/** Enables pipelining if \a enqueue is not empty: then, the compute
+	 * part of parallel tasks runs in the background through \a enqueue,
+	 * overlapping with the next timestep(s), and their commit is delayed
+	 * until wait_pipelined(). The context given to them is always that of
+	 * the step of their snapshot. */
+	void setPipelined(const enqueue_t& enqueue);
+
+	bool isPipelined() const { return static_cast<bool>(m_enqueue); }
+
+	/** Waits for the pipelined tasks running in the background, if any, and
+	 * runs their commit. Must be called before modifying or destroying
+	 * anything they use. Called by run_due_tasks() and clear(). */
+	void wait_pipelined();
+
+	/** Advances one timestep and runs all tasks due at it: first, the
+	 * snapshot and compute of all the parallel ones (see add_parallel())
+	 * through \a parallelFor, then the commit of these and the other tasks,
+	 * sequentially in registration order. When pipelining, parallel tasks
+	 * only take their snapshot here, and their commit is that of the
+	 * previous call.
+	 * \param[in] profiler If not null, the time of each task is measured
+	 * with it, using the task index as identifier. Pipelined computations
+	 * are not measured.
+	 * \param[in] parallelFor If empty, parallel tasks run sequentially.
+	 * \return The number of tasks run */
+	size_t run_due_tasks(
+		const TSimulContext& context, SimulableProfiler* profiler = nullptr,
+		const parallel_for_t& parallelFor = parallel_for_t());
+
+	/** Name of the i-th registered task, see add() */
+	const std::string& getTaskName(size_t i) const
+	{
+		return m_tasks.at(i).name;
+	}
+
+	/** Number of registered tasks */
+	size_t size() const { return m_tasks.size(); }
+
+	/** Number of tasks run in the last call to run_due_tasks() */
+	size_t getLastRunCount() const { return m_last_run_count; }
+
+	/** Total number of tasks run since the last clear() */
+	uint64_t getTotalRunCount() const { return m_total_run_count; }
+
+	double getTimestep() const { return m_dt; }
+
+   private:
+	struct Task
+	{
+		task_t f;  //!< The task, or the snapshot of parallel ones
+		task_t compute, commit;	 //!< Only for parallel tasks
+		bool parallel = false;
+		std::string name;
+		uint64_t period_steps = 1;
+		uint64_t next_step = 0;	 //!< Absolute index of the next run
+	};
+
+	std::vector<Task> m_tasks;
+
+	/** Indices in m_tasks, in slot `step % WHEEL_SIZE` */
+	std::vector<std::vector<size_t>> m_wheel;
+	/** Scratch copy of the slot being run, and its parallel tasks due */
+	std::vector<size_t> m_running, m_running_parallel;
+
+	enqueue_t m_enqueue;  //!< See setPipelined()
+	/** Parallel tasks computing in the background, see wait_pipelined() */
+	std::vector<size_t> m_pipelined;
+	std::vector<std::future<void>> m_pipelined_futures;
+	TSimulContext m_pipelined_context;
+
+	double m_dt = 10e-3;
+	uint64_t m_next_step = 0;  //!< Absolute index of the next step to run
+
+	size_t m_last_run_count = 0;
+	uint64_t m_total_run_count = 0;
+
+	void insertInWheel(size_t taskIdx);
+};
+}  // namespace mvsim
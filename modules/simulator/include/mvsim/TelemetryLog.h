@@ -0,0 +1,111 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mvsim
+{
+/** Binary telemetry log writer, for the "binary" format of CSVLogger.
+ *
+ * File format (little-endian):
+ *  - Header: 8-byte magic "MVSIMTLM", uint32 version, uint32 number of
+ *    columns, then each column name as uint32 length + chars.
+ *  - Blocks until the end of file: uint32 number of rows N, then N doubles
+ *    of the first column, N of the second one, etc.
+ *
+ * push() stores rows into a lock-free ring buffer, and a single background
+ * thread, shared by all writers and running only while any is open, writes
+ * them to disk in blocks, so the simulation thread never waits for file
+ * I/O.
+ * push() must be called from one thread at a time.
+ *
+ * Use TelemetryReader, or `mvsim telemetry`, to read these files.
+ */
+class TelemetryWriter
+{
+   public:
+	/** \param[in] ringRows Capacity of the ring buffer, in rows.
+	 *  \param[in] blockRows Rows per block in the file. */
+	TelemetryWriter(size_t ringRows = 8192, size_t blockRows = 1024);
+	~TelemetryWriter();
+
+	TelemetryWriter(const TelemetryWriter&) = delete;
+	TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+	/** Creates the file, writes the header and starts accepting rows.
+	 * \return false on error creating the file. */
+	bool open(
+		const std::string& fileName, const std::vector<std::string>& columns);
+
+	/** Writes all pending rows and closes the file */
+	void close();
+
+	bool isOpen() const { return m_file.is_open(); }
+
+	/** Enqueues one row (as many values as columns). Only waits if the ring
+	 * buffer is full, i.e. the disk cannot keep up. */
+	void push(const double* row);
+
+	/** Times push() had to wait for a full ring buffer */
+	uint64_t getStallCount() const { return m_stalls; }
+
+	/** Moves rows from the ring buffer into the current block, and writes
+	 * full blocks. Called from the flush thread, within m_drain_mtx. */
+	void drain();
+
+	/** Held by the flush thread while draining this writer, so close()
+	 * only waits for the I/O of its own file. */
+	std::mutex m_drain_mtx;
+
+   private:
+	const size_t m_ringRows, m_blockRows;
+	size_t m_nCols = 0;
+
+	std::vector<double> m_ring;	 //!< Row-major, m_ringRows x m_nCols
+	std::atomic<size_t> m_ringHead{0};	//!< Next row to write (producer)
+	std::atomic<size_t> m_ringTail{0};	//!< Next row to read (consumer)
+	std::atomic<uint64_t> m_stalls{0};
+
+	std::vector<double> m_block;  //!< Column-major, m_blockRows x m_nCols
+	size_t m_blockUsed = 0;
+
+	std::ofstream m_file;
+
+	void writeBlock();
+};
+
+/** Reads files written by TelemetryWriter */
+class TelemetryReader
+{
+   public:
+	TelemetryReader() = default;
+
+	/** Opens the file and reads its header.
+	 * \exception std::exception On error or invalid file format. */
+	void open(const std::string& fileName);
+
+	const std::vector<std::string>& getColumns() const { return m_columns; }
+
+	/** Reads the next block: one vector per column, all with the same
+	 * length. \return false at the end of the file. */
+	bool readBlock(std::vector<std::vector<double>>& columns);
+
+   private:
+	std::ifstream m_file;
+	std::vector<std::string> m_columns;
+};
+
+}  // namespace mvsim
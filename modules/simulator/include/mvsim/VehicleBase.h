@@ -16,6 +16,7 @@
 #include <mrpt/img/TColor.h>
 #include <mrpt/opengl/CSetOfLines.h>
 #include <mrpt/opengl/CSetOfObjects.h>
+#include <mrpt/opengl/CText.h>
 #include <mrpt/poses/CPose2D.h>
 #include <mvsim/ClassFactory.h>
 #include <mvsim/ControllerBase.h>
@@ -26,6 +27,7 @@
 #include <mvsim/Wheel.h>
 #include <mvsim/basic_types.h>
 
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <string>
@@ -54,12 +56,48 @@ class VehicleBase : public VisualObject, public Simulable
 	static void register_vehicle_class(
 		const rapidxml::xml_node<char>* xml_node);
 
+	/** Whether register_vehicle_class() was called for class \a name */
+	static bool is_registered_class(const std::string& name);
+
 	void poses_mutex_lock() override { m_gui_mtx.lock(); }
 	void poses_mutex_unlock() override { m_gui_mtx.unlock(); }
 
+	/** Also removes the objects of all sensors */
+	void guiRemove(mrpt::opengl::COpenGLScene& scene) override;
+
+	/** Renames a vehicle of class \a className removed by World::despawn(),
+	 * so it can be spawned again as a new instance: re-parses the settings
+	 * which depend on its name (<publish>, sensor topics and noise seeds)
+	 * and moves its loggers to the files of the new name. */
+	void recycleAs(const std::string& name, const std::string& className);
+
 	// ------- Interface with "World" ------
 	virtual void simul_pre_timestep(const TSimulContext& context) override;
 	virtual void simul_post_timestep(const TSimulContext& context) override;
+	void registerPeriodicTasks(TaskScheduler& scheduler) override;
+	bool simul_is_parallel_safe() const override { return true; }
+	/** Vehicles wake up their own bodies when applying motor forces */
+	bool simul_is_passive() const override { return false; }
+	void saveState(mrpt::serialization::CArchive& out) const override;
+	void restoreState(mrpt::serialization::CArchive& in) override;
+
+	/** Gets the parameters of this vehicle friction model, if it supports
+	 * batched evaluation. \sa FrictionBase::getBatchParams() */
+	bool getFrictionBatchParams(FrictionBatchParams& p) const;
+	/** Makes simul_pre_timestep() fill in the inputs of wheels
+	 * [firstWheel, firstWheel+getNumWheels()) of \a b, instead of evaluating
+	 * the friction model. Then, once the World has evaluated the batch,
+	 * apply_batched_friction() must be called before committing forces.
+	 * Use nullptr to go back to per-wheel evaluation. */
+	void setFrictionBatch(FrictionBatch* b, size_t firstWheel = 0)
+	{
+		m_friction_batch = b;
+		m_friction_batch_first = firstWheel;
+	}
+	/** Applies the forces of this vehicle wheels, from the (already
+	 * evaluated) batch set with setFrictionBatch() */
+	void apply_batched_friction(const TSimulContext& context);
+
 	virtual void apply_force(
 		const mrpt::math::TVector2D& force,
 		const mrpt::math::TPoint2D& applyPoint =
@@ -115,6 +153,17 @@ class VehicleBase : public VisualObject, public Simulable
 		return m_chassis_poly;
 	}
 
+	/** Level of detail of the simulation of this vehicle, set by World (see
+	 * World::TLODOptions). 0: full detail */
+	void setLODLevel(unsigned int level) { m_lod_level = level; }
+	unsigned int getLODLevel() const { return m_lod_level; }
+
+	/** Timestep number (counted since the world was loaded) until which
+	 * World skips simul_pre_timestep() of this vehicle, due to its level of
+	 * detail */
+	void setLODNextStep(uint64_t step) { m_lod_next_step = step; }
+	uint64_t getLODNextStep() const { return m_lod_next_step; }
+
 	/** Set the vehicle index in the World */
 	void setVehicleIndex(size_t idx) { m_vehicle_index = idx; }
 	/** Get the vehicle index in the World */
@@ -147,8 +196,30 @@ class VehicleBase : public VisualObject, public Simulable
    protected:
 	std::map<std::string, std::shared_ptr<CSVLogger>> m_loggers;
 	std::string m_log_path;
+	CSVLogger::Format m_log_format = CSVLogger::Format::CSV;
+
+	// Direct access to m_loggers entries and their columns, to avoid
+	// look-ups by name in each timestep. Set in initLoggers().
+	std::shared_ptr<CSVLogger> m_pose_logger;
+	std::vector<std::shared_ptr<CSVLogger>> m_wheel_loggers;
+	struct TPoseLogColumns
+	{
+		CSVLogger::column_t timestamp = 0, q_x = 0, q_y = 0, q_z = 0,
+							q_yaw = 0, q_pitch = 0, q_roll = 0, dq_x = 0,
+							dq_y = 0, dq_z = 0;
+	};
+	TPoseLogColumns m_pose_log_cols;
+	/** Same for all wheels */
+	struct TWheelLogColumns
+	{
+		CSVLogger::column_t timestamp = 0, torque = 0, weight = 0,
+							vel_x = 0, vel_y = 0, fric_x = 0, fric_y = 0;
+	};
+	TWheelLogColumns m_wheel_log_cols;
 
 	virtual void initLoggers();
+	/** Sets the file of each logger from m_log_path and the vehicle name */
+	void setLoggersFilepath();
 	virtual void writeLogStrings();
 	virtual void internalGuiUpdate(
 		mrpt::opengl::COpenGLScene& scene, bool childrenOnly) override;
@@ -168,6 +239,16 @@ class VehicleBase : public VisualObject, public Simulable
 		const TSimulContext& context,
 		std::vector<double>& out_force_per_wheel) = 0;
 
+	/** The body of simul_pre_timestep(), also used by VehicleSpecialized to
+	 * run it without virtual calls. NUM_WHEELS>0 fixes the number of wheels
+	 * at compile time (0: use getNumWheels()).
+	 * \param invokeControllers Called as invoke_motor_controllers().
+	 * Defined in the private header VehicleBase_impl.h */
+	template <size_t NUM_WHEELS, class INVOKE_CONTROLLERS>
+	void internal_simul_pre_timestep(
+		const TSimulContext& context,
+		const INVOKE_CONTROLLERS& invokeControllers);
+
 	/** user-supplied index number: must be set/get'ed with setVehicleIndex()
 	 * getVehicleIndex() (default=0) */
 	size_t m_vehicle_index;
@@ -204,6 +285,8 @@ class VehicleBase : public VisualObject, public Simulable
 	std::vector<b2Fixture*> m_fixture_wheels;  //!< [0]:rear-left, etc.
 											   //!(depending on derived class).
 											   //! Size set at constructor.
+	/** The shapes of m_fixture_wheels, to move them as wheels turn */
+	std::vector<b2PolygonShape*> m_wheel_shapes;
 
    private:
 	// Called from internalGuiUpdate_common()
@@ -211,9 +294,25 @@ class VehicleBase : public VisualObject, public Simulable
 	// Called from internalGuiUpdate_common()
 	void internal_internalGuiUpdate_forces(mrpt::opengl::COpenGLScene& scene);
 
+	/** Queues the friction force (local coords) of one wheel, logs it, and
+	 * saves it for rendering into \a force_vectors */
+	void internal_apply_wheel_friction(
+		const FrictionBase::TFrictionInput& fi, size_t wheelIndex,
+		const mrpt::math::TPoint2D& net_force,
+		std::vector<mrpt::math::TSegment3D>& force_vectors);
+	void internal_save_force_vectors(
+		const std::vector<mrpt::math::TSegment3D>& force_vectors);
+
+	FrictionBatch* m_friction_batch = nullptr;
+	size_t m_friction_batch_first = 0;
+
+	std::atomic<unsigned int> m_lod_level = 0;
+	uint64_t m_lod_next_step = 0;
+
 	mrpt::opengl::CSetOfObjects::Ptr m_gl_chassis;
 	std::vector<mrpt::opengl::CSetOfObjects::Ptr> m_gl_wheels;
 	mrpt::opengl::CSetOfLines::Ptr m_gl_forces;
+	mrpt::opengl::CText::Ptr m_gl_lod;
 	std::mutex m_force_segments_for_rendering_cs;
 	std::vector<mrpt::math::TSegment3D> m_force_segments_for_rendering;
 
@@ -0,0 +1,87 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mvsim
+{
+/** Parameters of one DynamicsKinematicLite vehicle, see
+ * KinematicLiteBatch::setParams() */
+struct KinematicLiteParams
+{
+	bool ackermann = false;	 //!< false: unicycle model
+	double wheelbase = 1.0;	 //!< Ackermann only (m)
+	double max_steer = 0.5;	 //!< Ackermann only (rad)
+	double max_speed = 1.0;	 //!< (m/s)
+	double max_omega = 1.0;	 //!< Unicycle only (rad/s)
+	double max_accel = 1.0;	 //!< (m/s^2). <=0: no limit
+	/** Stops before getting closer than this to other vehicles ahead (m) */
+	double safety_distance = 0.5;
+	double radius = 0.5;  //!< Of the chassis, see getMaxVehicleRadius()
+};
+
+/** Structure-of-arrays state of many DynamicsKinematicLite vehicles
+ * (typically, all of them in the World), integrated at once each timestep.
+ *
+ * Velocity commands are limited in speed and acceleration, and scaled down
+ * so agents do not run into other agents or obstacles (see addObstacle())
+ * ahead of them. Then, the new poses are integrated analytically (constant
+ * v,w along dt), and given as the velocity (vel_x,vel_y,w) that moves each
+ * agent from its current pose to the new one in one timestep.
+ *
+ * Use resize(), then setParams() for each agent. Inputs must be filled in
+ * before each evaluate().
+ */
+struct KinematicLiteBatch
+{
+	// Parameters (see KinematicLiteParams):
+	std::vector<uint8_t> ackermann;
+	std::vector<double> wheelbase, tan_max_steer, max_speed, max_omega,
+		max_accel, safety_distance, radius;
+
+	// Inputs:
+	std::vector<double> x, y, yaw;	//!< Current pose (global)
+	std::vector<double> cmd_v, cmd_w;  //!< Commanded twist (local)
+	/** Current speed and angular velocity: input and output */
+	std::vector<double> v, w;
+
+	// Outputs:
+	std::vector<double> vel_x, vel_y;  //!< Linear velocity (global)
+
+	size_t size() const { return x.size(); }
+	void resize(size_t n);
+
+	/** Sets the model parameters of agent \a i */
+	void setParams(size_t i, const KinematicLiteParams& p);
+
+	/** Other objects (not in the batch) to be avoided, as circles. Cleared
+	 * by each evaluate(). */
+	void addObstacle(double ox, double oy, double oradius);
+
+	/** Computes v, w and the outputs of all agents */
+	void evaluate(double dt);
+
+   private:
+	std::vector<double> m_obs_x, m_obs_y, m_obs_r;
+
+	// Spatial hash of agents and obstacles, rebuilt by evaluate():
+	std::vector<uint32_t> m_bucket_start;  //!< Size: buckets+1
+	std::vector<uint32_t> m_bucket_items;  //!< Sorted by bucket
+	std::vector<uint32_t> m_item_bucket;
+
+	/** Max. speed of agent \a i so it stops before any object ahead */
+	double internal_max_free_speed(
+		size_t i, double dir, double cellSize, uint32_t bucketMask) const;
+};
+
+}  // namespace mvsim
@@ -76,6 +76,9 @@ class DynamicsAckermann : public VehicleBase
 		virtual void load_config(const rapidxml::xml_node<char>& node) override;
 		virtual void teleop_interface(
 			const TeleopInput& in, TeleopOutput& out) override;
+		virtual void saveState(
+			mrpt::serialization::CArchive& out) const override;
+		virtual void restoreState(mrpt::serialization::CArchive& in) override;
 	};
 
 	/** PID controller that controls the vehicle with front traction & steering
@@ -95,6 +98,9 @@ class DynamicsAckermann : public VehicleBase
 		virtual void load_config(const rapidxml::xml_node<char>& node) override;
 		virtual void teleop_interface(
 			const TeleopInput& in, TeleopOutput& out) override;
+		virtual void saveState(
+			mrpt::serialization::CArchive& out) const override;
+		virtual void restoreState(mrpt::serialization::CArchive& in) override;
 
 		double KP, KI, KD;	//!< PID controller parameters
 		double max_torque;	//!< Maximum abs. value torque (for clamp) [Nm]
@@ -130,6 +136,9 @@ class DynamicsAckermann : public VehicleBase
 		virtual void load_config(const rapidxml::xml_node<char>& node) override;
 		virtual void teleop_interface(
 			const TeleopInput& in, TeleopOutput& out) override;
+		virtual void saveState(
+			mrpt::serialization::CArchive& out) const override;
+		virtual void restoreState(mrpt::serialization::CArchive& in) override;
 
 		double KP, KI, KD;	//!< PID controller parameters
 		double max_torque;	//!< Maximum abs. value torque (for clamp) [Nm]
@@ -165,9 +174,19 @@ class DynamicsAckermann : public VehicleBase
 	// See base class doc
 	virtual void invoke_motor_controllers(
 		const TSimulContext& context,
-		std::vector<double>& out_force_per_wheel) override;
+		m_controller->control_step(ci, co);
+		apply_controller_output(co, out_torque_per_wheel);
+	}
+}
+
+void DynamicsDifferential::apply_controller_output(
+	const TControllerOutput& co, std::vector<double>& out_torque_per_wheel)
+{
+	out_torque_per_wheel.resize(2);
+	out_torque_per_wheel[WHEEL_L] = co.wheel_torque_l;
+	out_torque_per_wheel[WHEEL_R] = co.wheel_torque_r;
+}
 
-   private:
 	ControllerBasePtr m_controller;	 //!< The installed controller
 
 	/** The maximum steering angle (rad). Determines min turning radius */
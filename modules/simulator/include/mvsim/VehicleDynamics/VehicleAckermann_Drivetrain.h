@@ -87,6 +87,9 @@ class DynamicsAckermannDrivetrain : public VehicleBase
 		virtual void load_config(const rapidxml::xml_node<char>& node) override;
 		virtual void teleop_interface(
 			const TeleopInput& in, TeleopOutput& out) override;
+		virtual void saveState(
+			mrpt::serialization::CArchive& out) const override;
+		virtual void restoreState(mrpt::serialization::CArchive& in) override;
 	};
 
 	/** PID controller that controls the vehicle with front traction & steering
@@ -106,6 +109,9 @@ class DynamicsAckermannDrivetrain : public VehicleBase
 		virtual void load_config(const rapidxml::xml_node<char>& node) override;
 		virtual void teleop_interface(
 			const TeleopInput& in, TeleopOutput& out) override;
+		virtual void saveState(
+			mrpt::serialization::CArchive& out) const override;
+		virtual void restoreState(mrpt::serialization::CArchive& in) override;
 
 		double KP, KI, KD;	//!< PID controller parameters
 		double max_torque;	//!< Maximum abs. value torque (for clamp) [Nm]
@@ -139,6 +145,9 @@ class DynamicsAckermannDrivetrain : public VehicleBase
 		virtual void load_config(const rapidxml::xml_node<char>& node) override;
 		virtual void teleop_interface(
 			const TeleopInput& in, TeleopOutput& out) override;
+		virtual void saveState(
+			mrpt::serialization::CArchive& out) const override;
+		virtual void restoreState(mrpt::serialization::CArchive& in) override;
 
 		double KP, KI, KD;	//!< PID controller parameters
 		double max_torque;	//!< Maximum abs. value torque (for clamp) [Nm]
@@ -64,6 +64,9 @@ class DynamicsDifferential : public VehicleBase
 			DynamicsDifferential::TControllerOutput& co) override;
 		virtual void teleop_interface(
 			const TeleopInput& in, TeleopOutput& out) override;
+		virtual void saveState(
+			mrpt::serialization::CArchive& out) const override;
+		virtual void restoreState(mrpt::serialization::CArchive& in) override;
 	};
 
 	/** PID controller that controls the vehicle twist: linear & angular
@@ -83,6 +86,9 @@ class DynamicsDifferential : public VehicleBase
 		virtual void load_config(const rapidxml::xml_node<char>& node) override;
 		virtual void teleop_interface(
 			const TeleopInput& in, TeleopOutput& out) override;
+		virtual void saveState(
+			mrpt::serialization::CArchive& out) const override;
+		virtual void restoreState(mrpt::serialization::CArchive& in) override;
 
 		double KP, KI, KD;	//!< PID controller parameters
 		double max_torque;	//!< Maximum abs. value torque (for clamp) [Nm]
@@ -119,6 +125,10 @@ class DynamicsDifferential : public VehicleBase
 		const TSimulContext& context,
 		std::vector<double>& out_force_per_wheel) override;
 
+	/** The part of invoke_motor_controllers() after the controller step */
+	void apply_controller_output(
+		const TControllerOutput& co, std::vector<double>& out_torque_per_wheel);
+
    private:
 	ControllerBasePtr m_controller;	 //!< The installed controller
 };
@@ -0,0 +1,106 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <mvsim/VehicleBase.h>
+#include <mvsim/VehicleDynamics/KinematicLiteBatch.h>
+
+namespace mvsim
+{
+/** Lightweight vehicles with unicycle or Ackermann kinematics, for large
+ * crowds of background agents: no wheels, friction or loggers, and a
+ * kinematic Box2D body (seen by sensors as the chassis shape, and pushing
+ * dynamic objects away, but not pushed by anything).
+ *
+ * World integrates all of them at once in a KinematicLiteBatch, instead of
+ * calling their simul_pre_timestep(). Velocity commands are limited to the
+ * vehicle max. speed, acceleration, and turn rate (or steering angle), and
+ * vehicles slow down to avoid other vehicles ahead of them (walls and
+ * blocks are not avoided).
+ *
+ * \sa class factory in VehicleBase::factory
+ */
+class DynamicsKinematicLite final : public VehicleBase
+{
+	DECLARES_REGISTER_VEHICLE_DYNAMICS(DynamicsKinematicLite)
+   public:
+	DynamicsKinematicLite(World* parent);
+
+	/** Stores the twist setpoint, applied by World each timestep */
+	class ControllerTwist : public ControllerBaseInterface
+	{
+	   public:
+		static const char* class_name() { return "twist"; }
+
+		double setpoint_lin_speed = 0;	//!< (m/s)
+		double setpoint_ang_speed = 0;	//!< (rad/s)
+
+		void load_config(const rapidxml::xml_node<char>& node);
+		virtual void teleop_interface(
+			const TeleopInput& in, TeleopOutput& out) override;
+		virtual bool setTwistCommand(const double vx, const double wz) override
+		{
+			setpoint_lin_speed = vx;
+			setpoint_ang_speed = wz;
+			return true;
+		}
+		virtual void saveState(
+			mrpt::serialization::CArchive& out) const override;
+		virtual void restoreState(mrpt::serialization::CArchive& in) override;
+	};
+
+	ControllerTwist& getController() { return m_controller; }
+	virtual ControllerBaseInterface* getControllerInterface() override
+	{
+		return &m_controller;
+	}
+
+	virtual mrpt::math::TTwist2D getVelocityLocalOdoEstimate() const override
+	{
+		return {m_v, 0, m_w};
+	}
+
+	/** Integrated by World, see class docs */
+	bool simul_is_batched() const override { return true; }
+	void simul_pre_timestep(const TSimulContext& context) override {}
+	/** Only updates the pose and twist (no wheels or loggers) */
+	void simul_post_timestep(const TSimulContext& context) override;
+
+	void create_multibody_system(b2World& world) override;
+
+	void saveState(mrpt::serialization::CArchive& out) const override;
+	void restoreState(mrpt::serialization::CArchive& in) override;
+
+	/** @name Interface with the World KinematicLiteBatch
+		@{ */
+	void setBatchParams(KinematicLiteBatch& b, size_t i) const;
+	void fillBatchInputs(KinematicLiteBatch& b, size_t i) const;
+	/** Stores v,w and moves the Box2D body along this timestep */
+	void applyBatchOutputs(const KinematicLiteBatch& b, size_t i);
+	/** @} */
+
+   protected:
+	// See base class docs
+	virtual void dynamics_load_params_from_xml(
+		const rapidxml::xml_node<char>* xml_node) override;
+	virtual void invoke_motor_controllers(
+		const TSimulContext& context,
+		std::vector<double>& out_force_per_wheel) override
+	{
+	}
+	/** No loggers at all */
+	void initLoggers() override {}
+
+   private:
+	ControllerTwist m_controller;
+	KinematicLiteParams m_params;
+	double m_v = 0, m_w = 0;  //!< Current local twist, set by the batch
+};
+}  // namespace mvsim
@@ -0,0 +1,63 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <mvsim/VehicleDynamics/VehicleAckermann.h>
+#include <mvsim/VehicleDynamics/VehicleDifferential.h>
+
+#include <string>
+
+namespace mvsim
+{
+/** A vehicle of type DYNAMICS, with its controller fixed at compile time to
+ * CONTROLLER, and NUM_WHEELS wheels. Its simul_pre_timestep() calls the
+ * controller without virtual dispatch, and with fixed-size loops over wheels.
+ *
+ * The friction model is not part of the specialization: the World evaluates
+ * all the built-in ones in its FrictionBatch, and any other one is called
+ * through FrictionBase::evaluate_friction() as in other vehicles.
+ *
+ * VehicleBase::factory() creates one of these, instead of a plain DYNAMICS
+ * object, whenever the XML description matches one of the combinations
+ * instantiated in VehicleSpecialized.cpp. See createSpecializedVehicle().
+ */
+template <class DYNAMICS, class CONTROLLER, size_t NUM_WHEELS>
+class VehicleSpecialized final : public DYNAMICS
+{
+   public:
+	VehicleSpecialized(World* parent);
+
+	void simul_pre_timestep(const TSimulContext& context) override;
+
+   protected:
+	void invoke_motor_controllers(
+		const TSimulContext& context,
+		std::vector<double>& out_torque_per_wheel) override;
+};
+
+using DynamicsDifferentialTwistPID = VehicleSpecialized<
+	DynamicsDifferential, DynamicsDifferential::ControllerTwistPID, 2>;
+
+using DynamicsAckermannFrontSteerPID = VehicleSpecialized<
+	DynamicsAckermann, DynamicsAckermann::ControllerFrontSteerPID, 4>;
+
+extern template class VehicleSpecialized<
+	DynamicsDifferential, DynamicsDifferential::ControllerTwistPID, 2>;
+extern template class VehicleSpecialized<
+	DynamicsAckermann, DynamicsAckermann::ControllerFrontSteerPID, 4>;
+
+/** Creates the VehicleSpecialized for the given class names of <dynamics>
+ * and <controller>, or returns nullptr if there is none for this
+ * combination. */
+VehicleBase::Ptr createSpecializedVehicle(
+	World* parent, const std::string& dynamicsClass,
+	const std::string& controllerClass);
+
+}  // namespace mvsim
@@ -15,6 +15,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace mvsim
 {
@@ -31,6 +32,11 @@ class VisualObject
 	 * current state */
 	virtual void guiUpdate(mrpt::opengl::COpenGLScene& scene);
 
+	/** Removes all objects inserted by guiUpdate() from the scene, e.g. when
+	 * the object is despawned from the World. They are kept, and inserted
+	 * back by the next call to guiUpdate(). */
+	virtual void guiRemove(mrpt::opengl::COpenGLScene& scene);
+
 	World* getWorldObject() { return m_world; }
 	const World* getWorldObject() const { return m_world; }
 
@@ -46,6 +52,9 @@ class VisualObject
 
    protected:
 	bool parseVisual(const rapidxml::xml_node<char>* visual_node);
+	/** Makes this object look as \a o, as if parseVisual() was called with
+	 * the same XML node, sharing its 3D models. */
+	void shareVisual(const VisualObject& o);
 
 	World* m_world;
 
@@ -59,7 +68,17 @@ class VisualObject
 		mrpt::opengl::COpenGLScene& scene, bool childrenOnly = false) = 0;
 	virtual mrpt::poses::CPose3D internalGuiGetVisualPose() { return {}; }
 
+	/** Inserts \a obj into the scene. Derived classes must use this instead
+	 * of COpenGLScene::insert(), so guiRemove() can undo it. */
+	void guiInsert(
+		mrpt::opengl::COpenGLScene& scene,
+		const std::shared_ptr<mrpt::opengl::CRenderizable>& obj);
+
    private:
+	/** All objects passed to guiInsert(), in order */
+	std::vector<std::shared_ptr<mrpt::opengl::CRenderizable>> m_glInserted;
+	bool m_glRemoved = false;  //!< Set by guiRemove()
+
 	mrpt::math::TPoint3D viz_bbmin_{-1.0, -1.0, .0}, viz_bbmax_{1.0, 1.0, 1.0};
 };
 }  // namespace mvsim
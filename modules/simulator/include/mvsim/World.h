@@ -12,9 +12,11 @@
 #include <Box2D/Dynamics/b2Body.h>
 #include <Box2D/Dynamics/b2World.h>
 #include <mrpt/core/bits_math.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/core/format.h>
 #include <mrpt/gui/CDisplayWindowGUI.h>
 #include <mrpt/img/TColor.h>
+#include <mrpt/math/TPoint2D.h>
 #include <mrpt/math/TPoint3D.h>
 #include <mrpt/obs/CObservation.h>
 #include <mrpt/system/COutputLogger.h>
@@ -22,14 +24,33 @@
 #include <mrpt/system/CTimeLogger.h>
 #include <mvsim/Block.h>
 #include <mvsim/Comms/Client.h>
+#include <mvsim/MPSCQueue.h>
+#include <mvsim/SimulableProfiler.h>
 #include <mvsim/TParameterDefinitions.h>
+#include <mvsim/TaskScheduler.h>
 #include <mvsim/VehicleBase.h>
+#include <mvsim/VehicleDynamics/KinematicLiteBatch.h>
 #include <mvsim/WorldElements/WorldElementBase.h>
 
+#include <atomic>
+#include <functional>
+#include <limits>
 #include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+
+namespace mrpt::io
+{
+class CFileGZOutputStream;
+}
 
 namespace mvsim
 {
+class DynamicsKinematicLite;
+
 /** Simulation happens inside a World object.
  * This is the central class for usage from user code, running the simulation,
  * loading XML models, managing GUI visualization, etc.
@@ -94,6 +115,8 @@ class World : public mrpt::system::COutputLogger
 	 * \note The minimum simulation time is the timestep set (e.g. via
 	 * set_simul_timestep()), even if time advanced further than the provided
 	 * "dt".
+	 * \note Does nothing while the simulation is paused, see
+	 * pauseSimulation().
 	 */
 	void run_simulation(double dt);
 
@@ -150,6 +173,167 @@ class World : public mrpt::system::COutputLogger
 
 	/** @} */
 
+	/** \name Real-time execution
+	  @{*/
+
+	/** What to do when timesteps are not run in time (e.g. CPU overload).
+	 * See runRealtime() */
+	enum class CatchUpPolicy : uint8_t
+	{
+		/** Run several timesteps in a row (up to max_burst_steps) to recover
+		 * the lost time. */
+		Burst = 0,
+		/** Drop the missed timesteps, keeping the rest aligned with the
+		 * original wall-clock schedule. The simulation falls behind. */
+		Skip,
+		/** Re-schedule the next timestep from now on, so the simulation
+		 * runs slower than requested while overloaded. */
+		SlowDown
+	};
+
+	struct TRealtimeOptions
+	{
+		CatchUpPolicy catch_up = CatchUpPolicy::Burst;
+		unsigned int max_burst_steps = 10;
+		/** If >0, stop once the simulation time reaches this value [s] */
+		double end_time = 0;
+
+		TRealtimeOptions() = default;
+	};
+
+	/** Statistics of the real-time engine, see getRealtimeStats() */
+	struct TRealtimeStats
+	{
+		uint64_t timesteps = 0;	 //!< Timesteps run
+		uint64_t overruns = 0;	//!< Wake-ups too late for their deadline
+		uint64_t skipped = 0;  //!< Timesteps dropped (CatchUpPolicy::Skip)
+		/** Wall-clock time minus ideal time for the current simulation time
+		 * (>0: simulation is behind) [s] */
+		double drift = 0;
+		double drift_max = 0;  //!< Maximum absolute drift [s]
+		/** Delay between each timer deadline and the actual wake-up [s] */
+		double jitter_mean = 0, jitter_std = 0, jitter_max = 0;
+
+		TRealtimeStats() = default;
+	};
+
+	/** Starts running the simulation in a dedicated thread, paced with the
+	 * wall clock: each timestep has an absolute deadline, so timer errors do
+	 * not accumulate. Returns immediately; see stopRealtime().
+	 * \param[in] rtf Real-time factor (>1: faster than real time)
+	 */
+	void runRealtime(
+		double rtf = 1.0, const TRealtimeOptions& options = TRealtimeOptions());
+
+	/** Starts the real-time engine as runRealtime() does, but only if it is
+	 * not running and the simulation is not paused, as one atomic operation
+	 * (e.g. for front-ends which keep it running from their main loop).
+	 * \return true if it was started */
+	bool runRealtimeIfStopped(
+		double rtf = 1.0, const TRealtimeOptions& options = TRealtimeOptions());
+
+	/** Stops the thread started by runRealtime(), if running, and waits for
+	 * it to end */
+	void stopRealtime();
+
+	/** Whether the real-time thread is running. It stops by itself upon
+	 * reaching TRealtimeOptions::end_time */
+	bool isRealtimeRunning() const { return m_realtime_running; }
+
+	/** Changes the real-time factor of a running runRealtime() engine */
+	void setRealtimeFactor(double rtf);
+
+	TRealtimeStats getRealtimeStats() const;
+
+	/** @} */
+
+	/** \name External (lock-step) control
+	 * For co-simulation or RL training, where an external process owns the
+	 * simulation clock. Also exposed as the "sim/pause", "sim/step" and
+	 * "sim/run" services, see connectToServer().
+	  @{*/
+
+	/** Stops advancing the simulation: stops the real-time engine, if
+	 * running, and makes run_simulation() return without running any
+	 * timestep, until resumeSimulation() is called. */
+	void pauseSimulation();
+
+	/** Resumes a paused simulation. If \a rtf>0, the real-time engine is
+	 * (re)started with that real-time factor; otherwise, it is restarted
+	 * only if it was running before pauseSimulation(). */
+	void resumeSimulation(double rtf = 0);
+
+	bool isPaused() const { return m_paused; }
+
+	/** Runs \a numSteps timesteps in the calling thread and returns once
+	 * they are done, pausing the simulation first if needed. Can be safely
+	 * called from any thread. */
+	void stepSimulation(size_t numSteps = 1);
+
+	/** @} */
+
+	/** \name Simulation state snapshots
+	  @{*/
+
+	/** Captures the dynamic state of the world into a binary blob: poses and
+	 * twists of all objects, wheels spinning state, controllers internals
+	 * (setpoints, PID), sensor timers and random generators, and the
+	 * simulation time and timestep count.
+	 * Static contents (maps, shapes, etc.) are not included, so the blob can
+	 * only be restored into this same world, or one loaded from the same XML
+	 * file. Objects created by spawn() are saved with their class, so
+	 * restoreState() creates them again (and removes those spawned after
+	 * the state was saved). Box2D internal caches (contacts, sleeping
+	 * timers) are not saved either.
+	 */
+	std::vector<uint8_t> saveState();
+
+	/** Restores a state saved with saveState().
+	 * \exception std::exception If the blob does not match this world.
+	 */
+	void restoreState(const std::vector<uint8_t>& state);
+
+	/** Like saveState(), but writes the blob to a file (e.g. for
+	 * checkpointing long runs) */
+	void saveStateToFile(const std::string& fileName);
+
+	/** Restores a state from a file written by saveStateToFile() */
+	void restoreStateFromFile(const std::string& fileName);
+
+	/** @} */
+
+	/** \name Input recording and replay
+	 * All inputs passed to enqueueInput() can be logged, tagged with the
+	 * timestep at which they were applied, so a run can be reproduced
+	 * afterwards, e.g. to debug field-reported issues. Commands passed to
+	 * enqueueCommand() are not recorded.
+	  @{*/
+
+	/** Starts logging all external inputs into a binary file. The log
+	 * begins with a saveState() snapshot, which includes the state of all
+	 * sensor random generators. For bit-exact replays, start recording right
+	 * after loading the world, since Box2D internal caches are not part of
+	 * snapshots.
+	 * \exception std::exception On error creating the file.
+	 */
+	void startInputRecording(const std::string& fileName);
+
+	/** Ends the log started by startInputRecording(), storing a checksum of
+	 * the final state. Does nothing if not recording. */
+	void stopInputRecording();
+
+	bool isRecordingInputs() const { return m_input_recording; }
+
+	/** Re-runs a log written by startInputRecording(), as fast as possible
+	 * in the calling thread. The world must have been loaded from the same
+	 * XML file used while recording.
+	 * \return true if the final state is bit-exact with the recorded one.
+	 * \exception std::exception On error reading the file.
+	 */
+	bool replayInputLog(const std::string& fileName);
+
+	/** @} */
+
 	/** \name Public types
 	  @{*/
 
@@ -168,6 +352,164 @@ class World : public mrpt::system::COutputLogger
 
 	/** @} */
 
+	/** \name Object handles
+	  @{*/
+
+	/** Stable integer identifier of a simulable object (vehicle, block or
+	 * world element), which is its index in the object table. Handles are
+	 * valid while their object exists: the handles of objects removed by
+	 * despawn() are given to the next objects created (the smallest one
+	 * first), so the table does not grow with spawn/despawn cycles. */
+	using ObjectHandle = uint32_t;
+
+	static constexpr ObjectHandle INVALID_OBJECT_HANDLE =
+		std::numeric_limits<ObjectHandle>::max();
+
+	/** Returns the handle of the object with the given name, or
+	 * INVALID_OBJECT_HANDLE if there is none */
+	ObjectHandle getObjectHandle(const std::string& name) const;
+
+	/** Returns the object with the given handle, or nullptr if the handle is
+	 * not valid */
+	Simulable* getObjectByHandle(ObjectHandle h) const
+	{
+		return h < m_object_table.size() ? m_object_table[h] : nullptr;
+	}
+
+	/** Number of entries in the object table (largest handle plus one) */
+	size_t getObjectTableSize() const { return m_object_table.size(); }
+
+	/** Packed copy of the most frequently accessed dynamic state of all
+	 * objects, with one entry per ObjectHandle, updated at the end of each
+	 * timestep. Do not read it while a timestep is running. */
+	struct ObjectsHotState
+	{
+		double simul_time = 0;	//!< Simulation time of this state
+		std::vector<mrpt::math::TPose3D> pose;	//!< See Simulable::getPose()
+		std::vector<mrpt::math::TTwist2D> twist;  //!< Simulable::getTwist()
+		/** See Simulable::isInCollision() */
+		std::vector<uint8_t> in_collision;
+		/** See Simulable::hadCollision() */
+		std::vector<uint8_t> had_collision;
+		/** Handle of each object name, see getObjectHandle() */
+		std::shared_ptr<const std::unordered_map<std::string, ObjectHandle>>
+			names;
+	};
+
+	const ObjectsHotState& getObjectsHotState() const { return m_hot_state; }
+
+	/** Returns an immutable copy of getObjectsHotState() as of the end of
+	 * the last timestep, which may be safely kept and read from any thread
+	 * without blocking the simulation. May be nullptr if no world was
+	 * loaded yet. */
+	std::shared_ptr<const ObjectsHotState> getPublishedObjectsState() const
+	{
+		return std::atomic_load(&m_hot_state_published);
+	}
+
+	/** Schedules \a cmd to be run by the simulation thread right before the
+	 * next timestep, e.g. to modify objects from other threads (services,
+	 * user interfaces...) without waiting for the timestep in course.
+	 * Commands run in the same order they were enqueued.
+	 * This method is lock-free and thread-safe.
+	 */
+	void enqueueCommand(std::function<void()>&& cmd)
+	{
+		m_command_queue.push(std::move(cmd));
+	}
+
+	/** An input from outside the simulation (services, ROS, keyboard...).
+	 * Unlike generic commands, these are recorded by startInputRecording().
+	 * See enqueueInput() */
+	struct TExternalInput
+	{
+		enum class Kind : uint8_t
+		{
+			SetPose = 0,  //!< Simulable::setPose(pose)
+			SetPoseRelative,  //!< Like SetPose, pose relative to the current
+			ResetCollisionFlag,	 //!< Simulable::resetCollisionFlag()
+			/** ControllerBaseInterface::setTwistCommand(vx,wz) */
+			TwistCommand,
+			/** ControllerBaseInterface::teleop_interface(keycode) */
+			TeleopKey,
+			Spawn,	//!< World::spawn(className, name, pose)
+			Despawn	 //!< World::despawn() of \a object
+		};
+
+		Kind kind = Kind::SetPose;
+		ObjectHandle object = INVALID_OBJECT_HANDLE;
+		mrpt::math::TPose3D pose;
+		double vx = 0, wz = 0;
+		int keycode = 0;
+		std::string className, name;  //!< For Spawn
+
+		/** Optional. Called from the simulation thread if the input is
+		 * refused (e.g. TwistCommand for a controller which does not
+		 * support them). Not recorded by startInputRecording(). */
+		std::function<void()> onRefused;
+
+		TExternalInput() = default;
+	};
+
+	/** Like enqueueCommand(), for an external input. Lock-free and
+	 * thread-safe. Inputs for invalid handles (or spawning objects that
+	 * spawn() would refuse) are ignored. */
+	void enqueueInput(const TExternalInput& in)
+	{
+		m_command_queue.push([this, in]() { internal_apply_input(in); });
+	}
+
+	/** @} */
+
+	/** \name Spawning and despawning objects at runtime
+	  @{*/
+
+	/** Creates a new vehicle or block of a class defined in the world file
+	 * (<vehicle:class> or <block:class>), named \a name, at \a pose.
+	 * Objects of the same class removed by despawn() are reused, if any.
+	 * Thread-safe: waits for the timestep in course, if any. Recorded by
+	 * startInputRecording(), like enqueueInput() inputs.
+	 * \return The handle of the new object.
+	 * \exception std::exception If the class does not exist or the name is
+	 * already in use.
+	 */
+	ObjectHandle spawn(
+		const std::string& className, const std::string& name,
+		const mrpt::math::TPose3D& pose);
+
+	/** Removes a vehicle or block from the world. Its handle is not valid
+	 * anymore, and will be reused by the next object created. Up to
+	 * m_spawn_pool_max objects per class created by spawn() are not
+	 * destroyed, but kept in a pool with their Box2D body (deactivated) and
+	 * 3D models, for later spawn() calls of the same class to reuse them.
+	 * Thread-safe, like spawn().
+	 * \return false if there is no vehicle or block with that name.
+	 */
+	bool despawn(const std::string& name);
+
+	/** @} */
+
+	/** \name Per-object profiling
+	  @{*/
+
+	/** Enables or disables measuring the time spent by each object in each
+	 * phase of the timestep (pre- and post-step, periodic tasks like sensors,
+	 * and GUI updates). Disabled by default. */
+	void enableProfiler(bool enable = true) { m_profiler.enable(enable); }
+	bool isProfilerEnabled() const { return m_profiler.isEnabled(); }
+
+	/** Discards all profiler measurements */
+	void clearProfiler();
+
+	/** Returns the \a n pairs (object, phase) with the largest accumulated
+	 * execution time, in decreasing order */
+	std::vector<SimulableProfiler::Entry> getProfilerTopN(size_t n);
+
+	/** Like getProfilerTopN(), formatted as a human-readable table */
+	std::string getProfilerReport(size_t n = 20);
+
+	/** @} */
+
 	/** \name Access inner working objects
 	  @{*/
 	std::unique_ptr<b2World>& getBox2DWorld() { return m_box2d_world; }
@@ -176,6 +518,14 @@ class World : public mrpt::system::COutputLogger
 		return m_box2d_world;
 	}
 	b2Body* getBox2DGroundBody() { return m_b2_ground_body; }
+
+	/** Runs \a f in the calling thread while no timestep is running, so it
+	 * may safely access the objects returned by the methods below (vehicles,
+	 * their controllers, etc.) while another thread runs the simulation (see
+	 * runRealtime()). The simulation waits for f() to return, so keep it
+	 * short. Must not be called from within a timestep. */
+	void runWithSimulationLocked(const std::function<void()>& f);
+
 	const VehicleList& getListOfVehicles() const { return m_vehicles; }
 	VehicleList& getListOfVehicles() { return m_vehicles; }
 	const BlockList& getListOfBlocks() const { return m_blocks; }
@@ -192,12 +542,21 @@ class World : public mrpt::system::COutputLogger
 	}
 
 	mrpt::system::CTimeLogger& getTimeLogger() { return m_timlogger; }
+
+	/** The scheduler of periodic tasks (sensors, publishers), e.g. to query
+	 * TaskScheduler::getLastRunCount() */
+	const TaskScheduler& getTaskScheduler() const { return m_task_scheduler; }
 	/** Replace macros, prefix the base_path if input filename is relative, etc.
 	 */
 	std::string resolvePath(const std::string& in_path) const;
 
 	std::string xmlPathToActualPath(const std::string& modelURI) const;
 
+	/** Loads a 3D model file, or returns the one this World already loaded
+	 * from the same file, so all objects using a model share it. */
+	std::shared_ptr<mrpt::opengl::CAssimpModel> loadVisualModel(
+		const std::string& localFileName);
+
 	/** @} */
 
 	/** \name Visitors API
@@ -228,6 +587,10 @@ class World : public mrpt::system::COutputLogger
 	 * description loaded from XML file. */
 	void connectToServer();
 
+	/** Whether connectToServer() was called. If not, objects do not publish
+	 * anything (e.g. for headless simulations). */
+	bool isConnectedToServer() const { return m_connected_to_server; }
+
 	mvsim::Client& commsClient() { return m_client; }
 	const mvsim::Client& commsClient() const { return m_client; }
 
@@ -236,6 +599,7 @@ class World : public mrpt::system::COutputLogger
 	friend class Block;
 
 	mvsim::Client m_client{"World"};
+	bool m_connected_to_server = false;
 
 	// -------- World Params ----------
 	/** Gravity acceleration (Default=9.8 m/s^2). Used to evaluate weights for
@@ -248,11 +612,36 @@ class World : public mrpt::system::COutputLogger
 	/** Velocity and position iteration count (refer to libbox2d docs) */
 	int m_b2d_vel_iters = 6, m_b2d_pos_iters = 3;
 
+	/** Number of threads for running simul_pre_timestep() and
+	 * simul_post_timestep() of vehicles and blocks, and sensors, in parallel
+	 * (1=all in the simulation thread, 0=one per hardware core) */
+	int m_simul_threads = 1;
+
+	/** If true, sensors are simulated in the background from a snapshot
+	 * of the world taken right after each physics step, overlapping with
+	 * the next timestep. Their observations are reported one timestep
+	 * later, with the simulation time of the snapshot. See
+	 * TaskScheduler::setPipelined() */
+	bool m_sensors_pipelined = false;
+
+	/** Maximum number of objects of each class kept by despawn() for spawn()
+	 * to reuse them. The rest are destroyed. */
+	unsigned int m_spawn_pool_max = 8;
+
+	/** Maximum number of timesteps run by each call to the "sim/step"
+	 * service. Other services wait for it to end, since they are all served
+	 * by the same thread. */
+	unsigned int m_sim_step_max_steps = 100;
+
 	const TParameterDefinitions m_other_world_params = {
 		{"gravity", {"%lf", &m_gravity}},
 		{"simul_timestep", {"%lf", &m_simul_timestep}},
 		{"b2d_vel_iters", {"%i", &m_b2d_vel_iters}},
 		{"b2d_pos_iters", {"%i", &m_b2d_pos_iters}},
+		{"simul_threads", {"%i", &m_simul_threads}},
+		{"sensors_pipelined", {"%bool", &m_sensors_pipelined}},
+		{"spawn_pool_max", {"%u", &m_spawn_pool_max}},
+		{"sim_step_max_steps", {"%u", &m_sim_step_max_steps}},
 	};
 
 	/** In seconds, real simulation time since beginning (may be different than
@@ -295,6 +684,47 @@ class World : public mrpt::system::COutputLogger
 	TGUI_Options m_gui_options;  //!< Some of these options are only used the
 								 //! first time the GUI window is created.
 
+	// ------- Level of detail -----
+	/** Vehicles far from all the "focus" vehicles run their
+	 * simul_pre_timestep() (controllers and wheel friction) only once every
+	 * few timesteps, with a dt that covers all of them, and the resulting
+	 * forces are held (in body coordinates) until the next run. Levels are
+	 * updated at each run, so vehicles go back to full detail at most one
+	 * interval after they get close again. Parsed from <lod>. */
+	struct TLODOptions
+	{
+		/** Names of the focus vehicles, separated by spaces or commas. Empty:
+		 * LOD disabled. The vehicle followed by the GUI camera, if any, is a
+		 * focus vehicle too. */
+		std::string focus;
+		/** Distances from the nearest focus vehicle beyond which vehicles go
+		 * to level 1 and 2 (m) */
+		double mid_distance = 30.0, far_distance = 60.0;
+		/** Vehicles only go back to a lower level once they are closer than
+		 * its distance minus this (m) */
+		double hysteresis = 2.0;
+		/** Timesteps between simul_pre_timestep() calls at level 1 and 2 */
+		unsigned int mid_decimation = 4, far_decimation = 16;
+
+		std::vector<std::string> focus_names;  //!< Parsed from "focus"
+
+		const TParameterDefinitions params = {
+			{"focus", {"%s", &focus}},
+			{"mid_distance", {"%lf", &mid_distance}},
+			{"far_distance", {"%lf", &far_distance}},
+			{"hysteresis", {"%lf", &hysteresis}},
+			{"mid_decimation", {"%u", &mid_decimation}},
+			{"far_decimation", {"%u", &far_decimation}},
+		};
+
+		TLODOptions() = default;
+		void parse_from(const rapidxml::xml_node<char>& node);
+
+		bool enabled() const { return !focus_names.empty(); }
+	};
+
+	TLODOptions m_lod_options;
+
 	// -------- World contents ----------
 	/** Mutex protecting simulation objects from multi-thread access */
 	std::recursive_mutex m_world_cs;
@@ -309,16 +739,225 @@ class World : public mrpt::system::COutputLogger
 	WorldElementList m_world_elements;
 	BlockList m_blocks;
 
+	/** Blocks parsed from <block:class> definitions, copied by
+	 * Block::factory() into instances that only set their pose. Also, the
+	 * class XML node they were parsed from, to detect re-definitions. */
+	struct TBlockPrototype
+	{
+		Block::Ptr block;
+		const rapidxml::xml_node<char>* class_root = nullptr;
+	};
+	std::map<std::string, TBlockPrototype> m_block_prototypes;
+
+	/** See loadVisualModel() */
+	std::map<std::string, std::shared_ptr<mrpt::opengl::CAssimpModel>>
+		m_visual_models;
+	std::mutex m_visual_models_mtx;
+
 	// List of all objects above (vehicles, world_elements, blocks), but as
 	// shared_ptr to their Simulable interfaces, so we can easily iterate on
 	// this list only for common tasks:
 	SimulableList m_simulableObjects;
 
+	/** All objects in m_simulableObjects, indexed by ObjectHandle, so
+	 * timesteps do not need to iterate the map */
+	std::vector<Simulable*> m_object_table;
+
+	/** Name to handle index, for getObjectHandle() */
+	std::unordered_map<std::string, ObjectHandle> m_object_names;
+
+	/** Entries of m_object_table left empty by despawn(), to be reused */
+	std::set<ObjectHandle> m_free_handles;
+
+	ObjectsHotState m_hot_state;
+
+	/** See getPublishedObjectsState() */
+	std::shared_ptr<const ObjectsHotState> m_hot_state_published;
+	/** Former published state, reused if nobody else holds it anymore */
+	std::shared_ptr<ObjectsHotState> m_hot_state_spare;
+	/** Set when m_object_names changes, to publish a new copy */
+	bool m_object_names_changed = true;
+
+	/** Copies m_hot_state into m_hot_state_published */
+	void internal_publish_hot_state();
+
+	/** See enqueueCommand() */
+	MPSCQueue<std::function<void()>> m_command_queue;
+
+	/** Runs all pending commands. Called within m_simulationStepRunningMtx */
+	void internal_process_command_queue();
+
+	/** saveState() and restoreState(), to be called within
+	 * m_simulationStepRunningMtx */
+	std::vector<uint8_t> internal_save_state();
+	void internal_restore_state(const std::vector<uint8_t>& state);
+
+	/** Applies (and records, if enabled) an input. Called within
+	 * m_simulationStepRunningMtx */
+	void internal_apply_input(const TExternalInput& in);
+
+	/** Timesteps run since the world was loaded */
+	uint64_t m_timestep_count = 0;
+
+	// Input recording, see startInputRecording():
+	std::shared_ptr<mrpt::io::CFileGZOutputStream> m_input_log;
+	std::atomic_bool m_input_recording = false;
+	uint64_t m_input_log_first_step = 0;
+
+	/** Adds an object to m_simulableObjects and the object table, with
+	 * handle \a h, which must be free, or the smallest free one if
+	 * INVALID_OBJECT_HANDLE. Returns its handle. */
+	ObjectHandle internal_insert_simulable(
+		const Simulable::Ptr& s, ObjectHandle h = INVALID_OBJECT_HANDLE);
+
+	/** Smallest vehicle (block) index not in use, see
+	 * VehicleBase::setVehicleIndex() and Block::setBlockIndex() */
+	size_t internal_unused_vehicle_index() const;
+	size_t internal_unused_block_index() const;
+
+	/** Objects removed by despawn(), to be reused by spawn() */
+	struct TSpawnPool
+	{
+		/** Simulable::saveState() of a new object, to reset reused ones */
+		std::vector<uint8_t> fresh_state;
+		std::vector<Simulable::Ptr> objects;
+	};
+	/** Pools by class name */
+	std::map<std::string, TSpawnPool> m_spawn_pools;
+	/** Class of each object created by spawn() */
+	std::map<const Simulable*, std::string> m_spawn_classes;
+
+	/** Despawned objects, to be removed from the 3D scene by the GUI */
+	std::vector<std::shared_ptr<VisualObject>> m_gui_despawned;
+	std::mutex m_gui_despawned_mtx;
+
+	/** Returns an error message if spawn() can not create this object */
+	std::string internal_check_spawn(
+		const std::string& className, const std::string& name) const;
+	/** Whether despawn() can remove this object */
+	bool internal_can_despawn(ObjectHandle h) const;
+
+	/** spawn() and despawn(), to be called within
+	 * m_simulationStepRunningMtx, once checked. The object is spawned with
+	 * handle \a h, if given (see internal_insert_simulable()). */
+	void internal_spawn(
+		const TExternalInput& in, ObjectHandle h = INVALID_OBJECT_HANDLE);
+	void internal_despawn(ObjectHandle h);
+
+	/** Destroys the Box2D body of a despawned object not to be reused. The
+	 * object itself is freed once the GUI removes it from the scene. */
+	void internal_release(Simulable::Ptr&& obj);
+
+	void internal_update_hot_state(ObjectHandle h);
+
 	/** Runs one individual time step */
 	void internal_one_timestep(double dt);
 
 	std::mutex m_simulationStepRunningMtx;
 
+	/** Worker threads for the parallel phases of each timestep, created
+	 * upon first use if m_simul_threads!=1 */
+	std::unique_ptr<mrpt::WorkerThreadsPool> m_simul_threads_pool;
+
+	/** Worker threads for pipelined sensors (see m_sensors_pipelined), apart
+	 * from m_simul_threads_pool, which is used meanwhile for the next
+	 * timestep */
+	std::unique_ptr<mrpt::WorkerThreadsPool> m_sensor_threads_pool;
+
+	/** Handles of objects not idle (see Simulable::simul_is_idle()), in
+	 * increasing order. Rebuilt before the pre- and post-steps. */
+	std::vector<ObjectHandle> m_active_objects;
+
+	/** Subset of m_active_objects with simul_is_parallel_safe()=true */
+	std::vector<ObjectHandle> m_parallel_objects;
+
+	void internal_update_active_simulables();
+
+	/** Periodic tasks of all objects, run at the end of each timestep */
+	TaskScheduler m_task_scheduler;
+
+	/** Set whenever objects are added or removed, or the simulation time is
+	 * changed, so m_task_scheduler is rebuilt before the next timestep. */
+	bool m_task_scheduler_outdated = true;
+
+	void internal_rebuild_task_scheduler(double dt);
+
+	/** Friction of the wheels of all vehicles whose friction model supports
+	 * it (see FrictionBase::getBatchParams()), evaluated at once between the
+	 * pre-step and the commit of forces. */
+	FrictionBatch m_friction_batch;
+	std::vector<VehicleBase*> m_friction_batch_vehicles;
+	std::vector<ObjectHandle> m_friction_batch_handles;
+	/** First wheel of each vehicle in m_friction_batch, plus its size() */
+	std::vector<size_t> m_friction_batch_first_wheel;
+
+	/** Set whenever objects are added or removed */
+	bool m_friction_batch_outdated = true;
+
+	void internal_rebuild_friction_batch();
+
+	/** All DynamicsKinematicLite vehicles, integrated at once after the
+	 * pre-step, and their handles */
+	KinematicLiteBatch m_kinematic_lite;
+	std::vector<DynamicsKinematicLite*> m_kinematic_lite_vehicles;
+	std::vector<ObjectHandle> m_kinematic_lite_handles;
+
+	/** Set whenever objects are added or removed */
+	bool m_kinematic_lite_outdated = true;
+
+	void internal_rebuild_kinematic_lite();
+
+	/** Vehicles subject to LOD (see TLODOptions), and their handles */
+	std::vector<std::pair<ObjectHandle, VehicleBase*>> m_lod_vehicles;
+	/** Indexed by handle: number of timesteps the next simul_pre_timestep()
+	 * is run for, with a dt that many times longer (1 at full detail), or 0
+	 * if it is skipped in this timestep. Updated by internal_update_lod() */
+	std::vector<uint32_t> m_lod_steps;
+	std::vector<mrpt::math::TPoint2D> m_lod_focus_points;
+
+	/** Set whenever objects are added or removed */
+	bool m_lod_outdated = true;
+
+	void internal_rebuild_lod();
+	/** Updates the LOD level of vehicles and m_lod_steps */
+	void internal_update_lod();
+
+	/** Runs f() on each entry of m_parallel_objects, split among the
+	 * worker threads, and waits for all of them to end. */
+	void internal_run_parallel_simulables(
+		const std::function<void(ObjectHandle)>& f);
+
+	/** Runs f(i) for i=0...n-1, split among the worker threads (see
+	 * m_simul_threads), and waits for all of them to end. */
+	void internal_parallel_for(
+		size_t n, const std::function<void(size_t)>& f);
+
+	SimulableProfiler m_profiler;
+
+	// Real-time engine, see runRealtime():
+	std::thread m_realtime_thread;
+	std::atomic_bool m_realtime_running = false;
+	std::atomic_bool m_realtime_must_stop = false;
+	std::atomic<double> m_realtime_factor = 1.0;
+	TRealtimeStats m_realtime_stats;
+	mutable std::mutex m_realtime_stats_mtx;
+	TRealtimeOptions m_realtime_options;  //!< Last used in runRealtime()
+
+	void internal_realtime_thread(TRealtimeOptions options);
+
+	// External control, see pauseSimulation():
+	std::atomic_bool m_paused = false;
+	bool m_realtime_was_running = false;  //!< Before pauseSimulation()
+
+	/** Held to start or stop the real-time engine, and to change
+	 * m_realtime_thread, m_paused or m_realtime_was_running. The real-time
+	 * thread never takes it, so it can be joined while holding it. */
+	std::mutex m_realtime_mtx;
+
+	/** Both with m_realtime_mtx held: */
+	void internal_run_realtime(double rtf, const TRealtimeOptions& options);
+	void internal_stop_realtime();
+
 	/** GUI stuff  */
 	struct GUI
 	{
@@ -349,6 +988,9 @@ class World : public mrpt::system::COutputLogger
 
 		void handle_mouse_operations();
 
+		/** Moves an object through World::enqueueInput() */
+		void enqueueSetPose(const Simulable& s, const mrpt::math::TPose3D& p);
+
 	   private:
 		World& m_parent;
 	};
@@ -360,6 +1002,8 @@ class World : public mrpt::system::COutputLogger
 	mrpt::system::CTicTac m_timer_iteration;
 
 	void process_load_walls(const rapidxml::xml_node<char>& node);
-	void insertBlock(const Block::Ptr& block);
+	/** Adds a block, with handle \a h (see internal_insert_simulable()) */
+	void insertBlock(
+		const Block::Ptr& block, ObjectHandle h = INVALID_OBJECT_HANDLE);
 };
 }  // namespace mvsim
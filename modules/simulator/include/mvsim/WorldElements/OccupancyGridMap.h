@@ -18,6 +18,7 @@
 #include <mvsim/WorldElements/WorldElementBase.h>
 
 #include <mutex>
+#include <vector>
 
 namespace mvsim
 {
@@ -35,6 +36,20 @@ class OccupancyGridMap : public WorldElementBase
 	const mrpt::maps::COccupancyGridMap2D& getOccGrid() const { return m_grid; }
 	mrpt::maps::COccupancyGridMap2D& getOccGrid() { return m_grid; }
 
+	/** Casts one ray from (x,y) (global coordinates, in meters) along
+	 * \a angle, and returns true if it hits an occupied cell within \a
+	 * maxRange, in which case \a outRange is set to its distance. Rays stop
+	 * without a hit at unknown cells or at the grid border.
+	 * Free space is skipped with the distance field, so long rays cost a few
+	 * steps instead of one per cell. */
+	bool castRay(
+		double x, double y, double angle, double maxRange,
+		float& outRange) const;
+
+	/** Recomputes the distance field used by castRay(). Called upon loading;
+	 * call it again after modifying the grid through getOccGrid(). */
+	void updateDistanceField();
+
 	void poses_mutex_lock() override {}
 	void poses_mutex_unlock() override {}
 
@@ -44,6 +59,10 @@ class OccupancyGridMap : public WorldElementBase
 
 	mrpt::maps::COccupancyGridMap2D m_grid;
 
+	/** Distance from each cell to the closest non-free cell (in cells, same
+	 * layout as the grid cells). See updateDistanceField() */
+	std::vector<float> m_dist_field;
+
 	bool m_gui_uptodate;  //!< Whether m_gl_grid has to be updated upon next
 						  //! call of internalGuiUpdate()
 	mrpt::opengl::CSetOfObjects::Ptr m_gl_grid;
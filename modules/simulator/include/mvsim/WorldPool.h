@@ -0,0 +1,86 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/system/COutputLogger.h>
+#include <mvsim/World.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mvsim
+{
+/** A set of independent World instances, advanced together in time by
+ * run_simulation() using a pool of worker threads (e.g. for reinforcement
+ * learning or Monte Carlo runs).
+ *
+ * Worlds in the pool have neither GUI nor communications, unless the user
+ * explicitly calls World::update_GUI() or World::connectToServer() on them.
+ */
+class WorldPool : public mrpt::system::COutputLogger
+{
+   public:
+	/** Creates an empty pool.
+	 * \param[in] numThreads Number of worker threads (0=one per hardware core)
+	 */
+	WorldPool(unsigned int numThreads = 0);
+	~WorldPool();
+
+	/** Appends \a numWorlds new worlds to the pool, each one loaded from the
+	 * same XML description. See World::load_from_XML()
+	 * \exception std::exception On any error loading the XML.
+	 */
+	void load_from_XML(
+		size_t numWorlds, const std::string& xml_text,
+		const std::string& fileNameForPath = std::string("."));
+
+	/** Appends an existing world to the pool */
+	void add(const std::shared_ptr<World>& world);
+
+	/** Removes all worlds and resets stats */
+	void clear();
+
+	size_t size() const { return m_worlds.size(); }
+	World& getWorld(size_t idx) { return *m_worlds.at(idx); }
+	const World& getWorld(size_t idx) const { return *m_worlds.at(idx); }
+
+	/** Advances each world by \a dt seconds (see World::run_simulation()),
+	 * in parallel, and returns once all of them are done.
+	 * \exception std::exception If any world raised an exception.
+	 */
+	void run_simulation(double dt);
+
+	/** Number of thread workers */
+	unsigned int getThreadCount() const { return m_numThreads; }
+
+	/** Total number of timesteps run by all worlds in run_simulation() since
+	 * construction or the last call to resetStats() */
+	size_t getTotalTimesteps() const { return m_total_timesteps; }
+
+	/** Wall-clock time spent in run_simulation() [seconds] */
+	double getTotalWallTime() const { return m_total_wall_time; }
+
+	/** Aggregate timesteps per second of wall-clock time, for all worlds */
+	double getStepsPerSecond() const;
+
+	void resetStats();
+
+   private:
+	std::vector<std::shared_ptr<World>> m_worlds;
+
+	unsigned int m_numThreads = 1;
+	mrpt::WorkerThreadsPool m_threads;
+
+	size_t m_total_timesteps = 0;
+	double m_total_wall_time = 0;
+};
+}  // namespace mvsim
@@ -14,6 +14,7 @@
 
 // Generic classes ------------------
 #include "World.h"
+#include "WorldPool.h"
 
 // Vehicles  ------------------
 #include "VehicleDynamics/VehicleAckermann.h"
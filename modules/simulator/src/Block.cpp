@@ -65,6 +65,11 @@ void Block::register_block_class(const rapidxml::xml_node<char>* xml_node)
 	block_classes_registry.add(ss.str());
 }
 
+bool Block::is_registered_class(const std::string& name)
+{
+	return block_classes_registry.get(name) != nullptr;
+}
+
 Block::Ptr Block::factory(World* parent, const rapidxml::xml_node<char>* root)
 {
 	using namespace std;
@@ -81,13 +86,14 @@ Block::Ptr Block::factory(World* parent, const rapidxml::xml_node<char>* root)
 	// --------------------------------------------------------------------------------
 	JointXMLnode<> block_root_node;
 	const rapidxml::xml_node<char>* class_root = nullptr;
+	std::string sClassName;
 	{
 		block_root_node.add(
 			root);  // Always search in root. Also in the class root, if any:
 		const xml_attribute<>* block_class = root->first_attribute("class");
 		if (block_class)
 		{
-			const string sClassName = block_class->value();
+			sClassName = block_class->value();
 			class_root = block_classes_registry.get(sClassName);
 			if (!class_root)
 				throw runtime_error(mrpt::format(
@@ -101,6 +107,31 @@ Block::Ptr Block::factory(World* parent, const rapidxml::xml_node<char>* root)
 	// ----------------------------------------------------
 	Block::Ptr block = Block::Ptr(new Block(parent));
 
+	// Instances of a class which only set their pose (and name) are copies
+	// of a prototype, parsed from the class definition once:
+	bool fromPrototype = false;
+	if (class_root)
+	{
+		fromPrototype = true;
+		for (auto n = root->first_node(); n && fromPrototype;
+			 n = n->next_sibling())
+			fromPrototype = !strcmp(n->name(), "init_pose") ||
+							!strcmp(n->name(), "init_vel") ||
+							!strcmp(n->name(), "publish");
+	}
+
+	if (fromPrototype)
+	{
+		auto& proto = parent->m_block_prototypes[sClassName];
+		if (!proto.block || proto.class_root != class_root)
+		{
+			proto.class_root = class_root;
+			proto.block = Block::Ptr(new Block(parent));
+			proto.block->internal_parse_params(nullptr, class_root);
+		}
+		block->internal_copy_params(*proto.block);
+	}
+
 	// Init params
 	// -------------------------------------------------
 	// attrib: name
@@ -152,51 +183,10 @@ Block::Ptr Block::factory(World* parent, const rapidxml::xml_node<char>* root)
 		}
 	}
 
-	// Custom visualization 3D model:
-	// -----------------------------------------------------------
-	block->parseVisual(block_root_node.first_node("visual"));
+	// Not in the prototype, since it may depend on the name:
 	block->parseSimulable(block_root_node.first_node("publish"));
 
-	// Params:
-	// -----------------------------------------------------------
-	parse_xmlnode_children_as_param(
-		*root, block->m_params, {}, "[Block::factory]");
-	if (class_root)
-		parse_xmlnode_children_as_param(
-			*class_root, block->m_params, {}, "[Block::factory]");
-
-	// Auto shape node from visual?
-	if (const rapidxml::xml_node<char>* xml_shape_viz =
-			block_root_node.first_node("shape_from_visual");
-		xml_shape_viz)
-	{
-		mrpt::math::TPoint3D bbmin, bbmax;
-		block->getVisualModelBoundingBox(bbmin, bbmax);
-		if (bbmin == bbmax)
-		{
-			THROW_EXCEPTION(
-				"Error: Tag <shape_from_visual/> found but bounding box of "
-				"visual object seems incorrect.");
-		}
-
-		block->m_block_poly.clear();
-		block->m_block_poly.emplace_back(bbmin.x, bbmin.y);
-		block->m_block_poly.emplace_back(bbmin.x, bbmax.y);
-		block->m_block_poly.emplace_back(bbmax.x, bbmax.y);
-		block->m_block_poly.emplace_back(bbmax.x, bbmin.y);
-
-		block->updateMaxRadiusFromPoly();
-	}
-
-	// Shape node (optional, fallback to default shape if none found)
-	if (const rapidxml::xml_node<char>* xml_shape =
-			block_root_node.first_node("shape");
-		xml_shape)
-	{
-		mvsim::parse_xmlnode_shape(
-			*xml_shape, block->m_block_poly, "[Block::factory]");
-		block->updateMaxRadiusFromPoly();
-	}
+	if (!fromPrototype) block->internal_parse_params(root, class_root);
 
 	// Register bodies, fixtures, etc. in Box2D simulator:
 	// ----------------------------------------------------
@@ -240,6 +230,89 @@ Block::Ptr Block::factory(World* parent, const std::string& xml_text)
 	return Block::factory(parent, xml.first_node());
 }
 
+void Block::recycleAs(const std::string& name, const std::string& className)
+{
+	const rapidxml::xml_node<char>* class_root =
+		block_classes_registry.get(className);
+	ASSERTMSG_(
+		class_root,
+		mrpt::format("Block class '%s' undefined", className.c_str()));
+
+	m_name = name;
+	parseSimulable(class_root->first_node("publish"));
+}
+
+void Block::internal_parse_params(
+	const rapidxml::xml_node<char>* root,
+	const rapidxml::xml_node<char>* class_root)
+{
+	JointXMLnode<> block_root_node;
+	if (root) block_root_node.add(root);
+	if (class_root) block_root_node.add(class_root);
+
+	// Custom visualization 3D model:
+	// -----------------------------------------------------------
+	parseVisual(block_root_node.first_node("visual"));
+
+	// Params:
+	// -----------------------------------------------------------
+	if (root)
+		parse_xmlnode_children_as_param(
+			*root, m_params, {}, "[Block::factory]");
+	if (class_root)
+		parse_xmlnode_children_as_param(
+			*class_root, m_params, {}, "[Block::factory]");
+
+	// Auto shape node from visual?
+	if (const rapidxml::xml_node<char>* xml_shape_viz =
+			block_root_node.first_node("shape_from_visual");
+		xml_shape_viz)
+	{
+		mrpt::math::TPoint3D bbmin, bbmax;
+		getVisualModelBoundingBox(bbmin, bbmax);
+		if (bbmin == bbmax)
+		{
+			THROW_EXCEPTION(
+				"Error: Tag <shape_from_visual/> found but bounding box of "
+				"visual object seems incorrect.");
+		}
+
+		m_block_poly.clear();
+		m_block_poly.emplace_back(bbmin.x, bbmin.y);
+		m_block_poly.emplace_back(bbmin.x, bbmax.y);
+		m_block_poly.emplace_back(bbmax.x, bbmax.y);
+		m_block_poly.emplace_back(bbmax.x, bbmin.y);
+
+		updateMaxRadiusFromPoly();
+	}
+
+	// Shape node (optional, fallback to default shape if none found)
+	if (const rapidxml::xml_node<char>* xml_shape =
+			block_root_node.first_node("shape");
+		xml_shape)
+	{
+		mvsim::parse_xmlnode_shape(
+			*xml_shape, m_block_poly, "[Block::factory]");
+		updateMaxRadiusFromPoly();
+	}
+}
+
+void Block::internal_copy_params(const Block& o)
+{
+	shareVisual(o);
+
+	m_mass = o.m_mass;
+	m_isStatic = o.m_isStatic;
+	m_block_poly = o.m_block_poly;
+	m_max_radius = o.m_max_radius;
+	m_block_z_min = o.m_block_z_min;
+	m_block_z_max = o.m_block_z_max;
+	m_block_color = o.m_block_color;
+	m_lateral_friction = o.m_lateral_friction;
+	m_ground_friction = o.m_ground_friction;
+	m_restitution = o.m_restitution;
+}
+
 void Block::simul_pre_timestep(const TSimulContext& context)
 {
 	Simulable::simul_pre_timestep(context);
@@ -277,7 +350,7 @@ void Block::internalGuiUpdate(
 			gl_poly->setColor_u8(m_block_color);
 			m_gl_block->insert(gl_poly);
 
-			scene.insert(m_gl_block);
+			guiInsert(scene, m_gl_block);
 		}
 
 		// Update them:
@@ -291,7 +364,7 @@ void Block::internalGuiUpdate(
 		m_gl_forces->setLineWidth(3.0);
 		m_gl_forces->setColor_u8(0xff, 0xff, 0xff);
 
-		scene.insert(m_gl_forces);  // forces are in global coords
+		guiInsert(scene, m_gl_forces);  // forces are in global coords
 	}
 
 	// Other common stuff:
@@ -6,23 +6,26 @@ CSVLogger::CSVLogger()
 }
 
 CSVLogger::~CSVLogger() { close(); }
-void CSVLogger::addColumn(std::string name) { m_columns[name] = 0.0; }
-void CSVLogger::updateColumn(std::string name, double value)
+
+CSVLogger::column_t CSVLogger::addColumn(const std::string& name)
 {
-	m_columns[name] = value;
+	for (column_t i = 0; i < m_names.size(); i++)
+		if (m_names[i] == name) return i;
+
+	m_names.push_back(name);
+	m_values.push_back(0.0);
+	return m_names.size() - 1;
 }
 
 bool CSVLogger::writeHeader()
 {
-	columns_type::iterator it;
-	for (it = m_columns.begin(); it != m_columns.end();)
-	{
-		*m_file << it->first;
+	// Binary files get their header upon open():
+	if (m_format == Format::Binary) return isOpen();
 
-		if (++it != m_columns.end())
-		{
-			*m_file << ", ";
-		}
+	for (size_t i = 0; i < m_names.size(); i++)
+	{
+		if (i > 0) *m_file << ", ";
+		*m_file << m_names[i];
 	}
 
 	*m_file << "\n";  // most CSV readers don't use \r\n
@@ -32,19 +35,21 @@ bool CSVLogger::writeHeader()
 
 bool CSVLogger::writeRow()
 {
-	if (!isRecording) return true;
+	if (!m_recording) return true;
 
 	if (!isOpen()) clear();
 
-	columns_type::iterator it;
-	for (it = m_columns.begin(); it != m_columns.end();)
+	if (m_format == Format::Binary)
 	{
-		*m_file << it->second;
+		if (!isOpen()) return false;
+		m_binary_file->push(m_values.data());
+		return true;
+	}
 
-		if (++it != m_columns.end())
-		{
-			*m_file << ", ";
-		}
+	for (size_t i = 0; i < m_values.size(); i++)
+	{
+		if (i > 0) *m_file << ", ";
+		*m_file << m_values[i];
 	}
 
 	*m_file << "\n";
@@ -54,19 +59,36 @@ bool CSVLogger::writeRow()
 
 bool CSVLogger::open()
 {
+	const std::string fileName = std::string("session") +
+								 std::to_string(currentSession) +
+								 std::string("-") + m_filepath;
+
+	if (m_format == Format::Binary)
+	{
+		if (!m_binary_file)
+			m_binary_file = std::make_unique<mvsim::TelemetryWriter>();
+		return m_binary_file->open(fileName, m_names);
+	}
+
 	if (m_file)
 	{
-		m_file->open((std::string("session") + std::to_string(currentSession) +
-					  std::string("-") + m_filepath)
-						 .c_str());
+		m_file->open(fileName.c_str());
 		return isOpen();
 	}
 	return false;
 }
 
-bool CSVLogger::isOpen() { return m_file->is_open(); }
+bool CSVLogger::isOpen()
+{
+	if (m_format == Format::Binary)
+		return m_binary_file && m_binary_file->isOpen();
+	return m_file->is_open();
+}
+
 bool CSVLogger::close()
 {
+	if (m_binary_file) m_binary_file->close();
+
 	if (m_file)
 	{
 		m_file->close();
@@ -109,3 +109,11 @@ void DefaultFriction::evaluate_friction(
 	// Rotate to put: Wheel frame ==> vehicle local framework:
 	wRot.composePoint(result_force_wrt_wheel, out_result_force_local);
 }
+
+bool DefaultFriction::getBatchParams(FrictionBatchParams& p) const
+{
+	p.mu = m_mu;
+	p.C_damping = m_C_damping;
+	p.A_roll = p.R1 = p.R2 = 0;
+	return true;
+}
@@ -61,8 +61,3 @@ FrictionBase::Ptr FrictionBase::factory(
 
 	return classFactory_friction.create(frict_class->value(), parent, xml_node);
 }
-
-void FrictionBase::setLogger(const std::weak_ptr<CSVLogger>& logger)
-{
-	m_logger = logger;
-}
@@ -0,0 +1,92 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mvsim/FrictionModels/FrictionBatch.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace mvsim;
+
+void FrictionBatch::resize(size_t n)
+{
+	for (auto* v :
+		 {&vel_x, &vel_y, &cos_yaw, &sin_yaw, &torque, &weight, &mass, &Iyy,
+		  &radius, &mu, &C_damping, &A_roll, &R1, &R2, &w, &dt, &force_x,
+		  &force_y, &F_rr})
+		v->assign(n, 0.0);
+	numRollingResistance = 0;
+}
+
+void FrictionBatch::setParams(size_t i, const FrictionBatchParams& p)
+{
+	mu[i] = p.mu;
+	C_damping[i] = p.C_damping;
+	A_roll[i] = p.A_roll;
+	R1[i] = p.R1;
+	R2[i] = p.R2;
+}
+
+// Same model as DefaultFriction::evaluate_friction() and
+// WardIagnemmaFriction::evaluate_friction(), see their comments.
+void FrictionBatch::evaluate(
+	const double gravity, const size_t first, const size_t last)
+{
+	// 1) Rolling resistance, only for the first wheels (F_rr of the rest
+	// remains zero from resize()):
+	const size_t lastRR = std::min(last, numRollingResistance);
+	for (size_t i = first; i < lastRR; i++)
+	{
+		const double vx = cos_yaw[i] * vel_x[i] + sin_yaw[i] * vel_y[i];
+		const double partial_mass = weight[i] / gravity + mass[i];
+		const double sign = static_cast<double>((vx > 0) - (vx < 0));
+		F_rr[i] = -sign * partial_mass * gravity *
+				  (R1[i] * (1 - std::exp(-A_roll[i] * std::abs(vx))) +
+				   R2[i] * std::abs(vx));
+	}
+
+	// 2) Lateral and longitudinal friction. Branch-free, so compilers can
+	// vectorize it:
+	for (size_t i = first; i < last; i++)
+	{
+		const double c = cos_yaw[i], s = sin_yaw[i];
+
+		// Vehicle frame => wheel frame:
+		const double vx = c * vel_x[i] + s * vel_y[i];
+		const double vy = -s * vel_x[i] + c * vel_y[i];
+
+		const double partial_mass = weight[i] / gravity + mass[i];
+		const double max_friction = mu[i] * partial_mass * gravity;
+
+		const double lat = std::min(
+			std::max(-vy * partial_mass / dt[i], -max_friction),
+			max_friction);
+
+		const double R = radius[i];
+		const double wi = w[i];
+		const double desired_wheel_alpha = (vx / R - wi) / dt[i];
+
+		const double lon = std::min(
+			std::max(
+				(torque[i] - Iyy[i] * desired_wheel_alpha -
+				 C_damping[i] * wi) /
+						R +
+					F_rr[i],
+				-max_friction),
+			max_friction);
+
+		const double actual_wheel_alpha =
+			(torque[i] - R * lon - C_damping[i] * wi) / Iyy[i];
+		w[i] = wi + actual_wheel_alpha * dt[i];
+
+		// Wheel frame => vehicle frame:
+		force_x[i] = c * lon - s * lat;
+		force_y[i] = s * lon + c * lat;
+	}
+}
@@ -107,10 +107,7 @@ void WardIagnemmaFriction::evaluate_friction(
 		-sign(vel_w.x) * partial_mass * gravity *
 		(m_R1 * (1 - exp(-m_A_roll * fabs(vel_w.x))) + m_R2 * fabs(vel_w.x));
 
-	if (!m_logger.expired())
-	{
-		m_logger.lock()->updateColumn("F_rr", F_rr);
-	}
+	if (m_logger) m_logger->updateColumn(m_col_F_rr, F_rr);
 
 	const double I_yy = input.wheel.Iyy;
 	//                                  There are torques this is force   v
@@ -141,3 +138,24 @@ void WardIagnemmaFriction::evaluate_friction(
 	// Rotate to put: Wheel frame ==> vehicle local framework:
 	wRot.composePoint(result_force_wrt_wheel, out_result_force_local);
 }
+
+void WardIagnemmaFriction::registerLogColumns(CSVLogger& logger)
+{
+	m_col_F_rr = logger.addColumn("F_rr");
+}
+
+bool WardIagnemmaFriction::getBatchParams(FrictionBatchParams& p) const
+{
+	p.mu = m_mu;
+	p.C_damping = m_C_damping;
+	p.A_roll = m_A_roll;
+	p.R1 = m_R1;
+	p.R2 = m_R2;
+	return true;
+}
+
+void WardIagnemmaFriction::logBatchOutputs(
+	CSVLogger& logger, const FrictionBatch& b, size_t i) const
+{
+	logger.updateColumn(m_col_F_rr, b.F_rr[i]);
+}
@@ -7,6 +7,7 @@
   |   See COPYING                                                           |
   +-------------------------------------------------------------------------+ */
 
+#include <mrpt/serialization/CArchive.h>
 #include <mvsim/PID_Controller.h>
 
 using namespace mvsim;
@@ -49,3 +50,13 @@ double PID_Controller::compute(double err, double dt)
 
 	return output;
 }
+
+void PID_Controller::saveState(mrpt::serialization::CArchive& out) const
+{
+	out << lastOutput << e_n << e_n_1 << e_n_2;
+}
+
+void PID_Controller::restoreState(mrpt::serialization::CArchive& in)
+{
+	in >> lastOutput >> e_n >> e_n_1 >> e_n_2;
+}
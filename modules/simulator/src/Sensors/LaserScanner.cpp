@@ -9,12 +9,18 @@
 
 #include <mrpt/core/lock_helper.h>
 #include <mrpt/opengl/COpenGLScene.h>
-#include <mrpt/random.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/CTicTac.h>
 #include <mvsim/Sensors/LaserScanner.h>
 #include <mvsim/VehicleBase.h>
 #include <mvsim/World.h>
 #include <mvsim/WorldElements/OccupancyGridMap.h>
 
+#include <algorithm>
+#include <functional>  // std::hash
+#include <random>
+
+#include "ScanRayCaster.h"
 #include "xml_utils.h"
 
 using namespace mvsim;
@@ -28,7 +34,8 @@ LaserScanner::LaserScanner(
 	  m_z_order(++z_order_cnt),
 	  m_rangeStdNoise(0.01),
 	  m_angleStdNoise(mrpt::DEG2RAD(0.01)),
-	  m_see_fixtures(true)
+	  m_see_fixtures(true),
+	  m_ray_caster(std::make_unique<ScanRayCaster>())
 {
 	this->loadConfigFrom(root);
 }
@@ -78,12 +85,29 @@ void LaserScanner::loadConfigFrom(const rapidxml::xml_node<char>* root)
 	m_scan_model.aperture = mrpt::DEG2RAD(fov_deg);
 	m_scan_model.resizeScan(nRays);
 
+	// Ray directions, relative to the sensor:
+	ASSERT_(nRays >= 2);
+	const double A0 =
+		(m_scan_model.rightToLeft ? -0.5 : +0.5) * m_scan_model.aperture;
+	const double AA = (m_scan_model.rightToLeft ? 1.0 : -1.0) *
+					  (m_scan_model.aperture / (nRays - 1));
+	m_ray_cos.resize(nRays);
+	m_ray_sin.resize(nRays);
+	for (int i = 0; i < nRays; i++)
+	{
+		m_ray_cos[i] = std::cos(A0 + AA * i);
+		m_ray_sin[i] = std::sin(A0 + AA * i);
+	}
+
 	// Assign a sensible default name/sensor label if none is provided:
 	if (m_name.empty())
 	{
 		const size_t nextIdx = m_vehicle.getSensors().size() + 1;
 		m_name = mrpt::format("laser%u", static_cast<unsigned int>(nextIdx));
 	}
+
+	// Repeatible, but different noise for each sensor:
+	m_rnd.seed(std::hash<std::string>()(m_vehicle.getName() + "/" + m_name));
 }
 
 void LaserScanner::internalGuiUpdate(
@@ -101,20 +125,20 @@ void LaserScanner::internalGuiUpdate(
 		// m_gl_scan->setSurfaceColor(0.0f, 0.0f, 1.0f, 0.4f);
 
 		m_gl_scan->setLocalRepresentativePoint({0, 0, 0.10f});
-		scene.insert(m_gl_scan);
+		guiInsert(scene, m_gl_scan);
 	}
 
-	if (!m_gui_uptodate)
 	{
+		std::lock_guard<std::mutex> csl(m_last_scan_cs);
+		if (!m_gui_uptodate)
 		{
-			std::lock_guard<std::mutex> csl(m_last_scan_cs);
 			if (m_last_scan2gui)
 			{
 				m_gl_scan->setScan(*m_last_scan2gui);
 				m_last_scan2gui.reset();
 			}
+			m_gui_uptodate = true;
 		}
-		m_gui_uptodate = true;
 	}
 
 	const double z_incrs = 10e-3;  // for m_z_order
@@ -129,198 +153,153 @@ void LaserScanner::simul_pre_timestep([
 {
 }
 
-// Simulate sensor AFTER timestep, with the updated vehicle dynamical state:
-void LaserScanner::simul_post_timestep(const TSimulContext& context)
+// Simulate sensor AFTER timestep, with the updated vehicle dynamical state.
+// Invoked every m_sensor_period only, see SensorBase::registerPeriodicTasks()
+void LaserScanner::simul_sensor_snapshot(
+	[[maybe_unused]] const TSimulContext& context)
 {
-	auto lck = mrpt::lockHelper(m_gui_mtx);
-
-	Simulable::simul_post_timestep(context);
+	mrpt::system::CTicTac tictac;
 
-	using mrpt::maps::COccupancyGridMap2D;
-	using mrpt::obs::CObservation2DRangeScan;
-
-	// Limit sensor rate:
-	if (context.simul_time < m_sensor_last_timestamp + m_sensor_period) return;
-
-	m_sensor_last_timestamp = context.simul_time;
-
-	// Create an array of scans, each reflecting ranges to one kind of world
-	// objects.
-	// Finally, we'll take the shortest range in each direction:
-	std::list<CObservation2DRangeScan> lstScans;
+	// Pose of the robot and the sensor:
+	const mrpt::poses::CPose2D& vehPose = m_vehicle.getCPose2D();
+	m_snapshot_pose = vehPose + mrpt::poses::CPose2D(m_scan_model.sensorPose);
+	m_snapshot_time = mrpt::system::now();
+
+	// Grid maps are never modified while simulating:
+	m_snapshot_grids.clear();
+	for (const auto& element : m_world->getListOfWorldElements())
+		if (const auto* grid =
+				dynamic_cast<const OccupancyGridMap*>(element.get());
+			grid)
+			m_snapshot_grids.push_back(grid);
+
+	// Box2D fixtures within range, except those of our own vehicle:
+	if (m_see_fixtures)
+		m_ray_caster->gather(
+			*m_world->getBox2DWorld(), m_snapshot_pose.x(),
+			m_snapshot_pose.y(), m_scan_model.maxRange,
+			m_vehicle.getBox2DChassisBody());
+
+	m_time_polygons = tictac.Tac();
+}
 
+// Only uses the snapshot above, since it may run during the next timestep:
+void LaserScanner::simul_sensor_compute(
+	[[maybe_unused]] const TSimulContext& context)
+{
 	const size_t nRays = m_scan_model.getScanSize();
 	const double maxRange = m_scan_model.maxRange;
 
-	// Get pose of the robot:
-	const mrpt::poses::CPose2D& vehPose = m_vehicle.getCPose2D();
-
-	// grid maps:
-	// -------------
-	m_world->getTimeLogger().enter("LaserScanner.scan.1.gridmap");
+	// Each kind of world object is ray traced in turn, keeping the shortest
+	// valid range in each direction. The scan reuses the memory of a former
+	// one, once released by all its consumers:
+	auto lastScan = m_obs_pool.acquire();
+	*lastScan = m_scan_model;
 
-	const World::WorldElementList& elements = m_world->getListOfWorldElements();
+	lastScan->timestamp = m_snapshot_time;
+	lastScan->sensorLabel = m_name;
 
-	for (const auto& element : elements)
-	{
-		// If not a grid map, ignore:
-		const OccupancyGridMap* grid =
-			dynamic_cast<const OccupancyGridMap*>(element.get());
-		if (!grid) continue;
-		const COccupancyGridMap2D& occGrid = grid->getOccGrid();
-
-		// Create new scan:
-		lstScans.emplace_back(m_scan_model);
-		CObservation2DRangeScan& scan = lstScans.back();
-
-		// Ray tracing over the gridmap:
-		occGrid.laserScanSimulator(
-			scan, vehPose, 0.5f, m_scan_model.getScanSize(), m_rangeStdNoise, 1,
-			m_angleStdNoise);
-	}
-	m_world->getTimeLogger().leave("LaserScanner.scan.1.gridmap");
+	lastScan->resizeScanAndAssign(nRays, maxRange, false);
 
-	// ray trace on Box2D polygons:
-	// ------------------------------
-	m_world->getTimeLogger().enter("LaserScanner.scan.2.polygons");
-	{
-		// Create new scan:
-		lstScans.push_back(CObservation2DRangeScan(m_scan_model));
-		CObservation2DRangeScan& scan = lstScans.back();
-
-		// Avoid the lidar seeing the vehicle owns shape:
-		std::map<b2Fixture*, void*> orgUserData;
-
-		auto makeFixtureInvisible = [&](b2Fixture* f) {
-			if (!f) return;
-			orgUserData[f] = f->GetUserData();
-			f->SetUserData(INVISIBLE_FIXTURE_USER_DATA);
-		};
-		auto undoInvisibleFixtures = [&]() {
-			for (auto& kv : orgUserData) kv.first->SetUserData(kv.second);
-		};
-
-		makeFixtureInvisible(m_vehicle.get_fixture_chassis());
-		for (auto& f : m_vehicle.get_fixture_wheels()) makeFixtureInvisible(f);
-
-		// Do Box2D raycasting stuff:
-		// ------------------------------
-		// This callback finds the closest hit. Polygon 0 is filtered.
-		class RayCastClosestCallback : public b2RayCastCallback
-		{
-		   public:
-			RayCastClosestCallback() : m_see_fixtures(true), m_hit(false) {}
-			float32 ReportFixture(
-				b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal,
-				float32 fraction) override
-			{
-				if (!m_see_fixtures ||
-					fixture->GetUserData() == INVISIBLE_FIXTURE_USER_DATA)
-				{
-					// By returning -1, we instruct the calling code to ignore
-					// this fixture and
-					// continue the ray-cast to the next fixture.
-					return -1.0f;
-				}
-
-				m_hit = true;
-				m_point = point;
-				m_normal = normal;
-				// By returning the current fraction, we instruct the calling
-				// code to clip the ray and
-				// continue the ray-cast to the next fixture. WARNING: do not
-				// assume that fixtures
-				// are reported in order. However, by clipping, we can always
-				// get the closest fixture.
-				return fraction;
-			}
+	const auto fuseRange = [&lastScan](size_t i, float range) {
+		lastScan->setScanRange(i, std::min(lastScan->getScanRange(i), range));
+		lastScan->setScanRangeValidity(i, true);
+	};
 
-			bool m_see_fixtures;
-			bool m_hit;
-			b2Vec2 m_point;
-			b2Vec2 m_normal;
-		};
+	const mrpt::poses::CPose2D& sensorPose = m_snapshot_pose;
 
-		const mrpt::poses::CPose2D sensorPose =
-			vehPose + mrpt::poses::CPose2D(scan.sensorPose);
-		const b2Vec2 sensorPt = b2Vec2(sensorPose.x(), sensorPose.y());
+	// Timings, see simul_post_timestep_commit():
+	mrpt::system::CTicTac tictac;
 
-		RayCastClosestCallback callback;
-		callback.m_see_fixtures = m_see_fixtures;
+	// grid maps:
+	// -------------
+	tictac.Tic();
 
-		// Scan size:
-		ASSERT_(nRays >= 2);
-		scan.resizeScanAndAssign(nRays, maxRange, false);
-		double A =
-			sensorPose.phi() + (scan.rightToLeft ? -0.5 : +0.5) * scan.aperture;
-		const double AA =
-			(scan.rightToLeft ? 1.0 : -1.0) * (scan.aperture / (nRays - 1));
+	// Normalized gaussian noise. Created here, so it carries no state
+	// between scans:
+	std::normal_distribution<double> randn;
 
-		auto& rnd = mrpt::random::getRandomGenerator();
+	for (const OccupancyGridMap* grid : m_snapshot_grids)
+	{
+		// Ray tracing over the gridmap. Noise is drawn from our own random
+		// generator instead of MRPT's global one, so independent worlds can
+		// be simulated from different threads:
+		double A = sensorPose.phi() +
+				   (m_scan_model.rightToLeft ? -0.5 : +0.5) *
+					   m_scan_model.aperture;
+		const double AA = (m_scan_model.rightToLeft ? 1.0 : -1.0) *
+						  (m_scan_model.aperture / (nRays - 1));
 
 		for (size_t i = 0; i < nRays; i++, A += AA)
 		{
-			const b2Vec2 endPt = b2Vec2(
-				sensorPt.x + cos(A) * maxRange, sensorPt.y + sin(A) * maxRange);
-
-			callback.m_hit = false;
-			m_world->getBox2DWorld()->RayCast(&callback, sensorPt, endPt);
-			scan.setScanRangeValidity(i, callback.m_hit);
-
-			float range = scan.getScanRange(i);
-			if (callback.m_hit)
-			{
-				// Hit:
-				range = std::sqrt(
-					mrpt::square(callback.m_point.x - sensorPt.x) +
-					mrpt::square(callback.m_point.y - sensorPt.y));
-				range += rnd.drawGaussian1D_normalized() * m_rangeStdNoise;
-			}
-			else
-			{
-				// Miss:
-				range = maxRange;
-			}
-			scan.setScanRange(i, range);
-		}  // end for (raycast scan)
-
-		undoInvisibleFixtures();
+			float range = maxRange;
+			if (grid->castRay(
+					sensorPose.x(), sensorPose.y(),
+					A + randn(m_rnd) * m_angleStdNoise, maxRange, range))
+				fuseRange(i, range + randn(m_rnd) * m_rangeStdNoise);
+		}
 	}
-	m_world->getTimeLogger().leave("LaserScanner.scan.2.polygons");
-
-	// Summarize all scans in one single scan:
-	// ----------------------------------------
-	m_world->getTimeLogger().enter("LaserScanner.scan.3.merge");
+	m_time_gridmap = tictac.Tac();
 
-	auto lastScan = CObservation2DRangeScan::Create(m_scan_model);
-
-	lastScan->timestamp = mrpt::system::now();
-	lastScan->sensorLabel = m_name;
-
-	lastScan->resizeScanAndAssign(nRays, maxRange, false);
-
-	for (const auto& scan : lstScans)
+	// ray trace on Box2D polygons:
+	// ------------------------------
+	tictac.Tic();
+	if (m_see_fixtures)
 	{
+		// Global directions of rays, from the precomputed table:
+		const double c0 = std::cos(sensorPose.phi());
+		const double s0 = std::sin(sensorPose.phi());
+		m_ray_dx.resize(nRays);
+		m_ray_dy.resize(nRays);
+		m_ray_range.resize(nRays);
 		for (size_t i = 0; i < nRays; i++)
 		{
-			if (scan.getScanRangeValidity(i))
-			{
-				lastScan->setScanRange(
-					i,
-					std::min(lastScan->getScanRange(i), scan.getScanRange(i)));
-				lastScan->setScanRangeValidity(i, true);
-			}
+			m_ray_dx[i] = c0 * m_ray_cos[i] - s0 * m_ray_sin[i];
+			m_ray_dy[i] = s0 * m_ray_cos[i] + c0 * m_ray_sin[i];
 		}
+
+		// All rays at once, against the fixtures gathered in the snapshot:
+		m_ray_caster->cast(
+			m_ray_dx.data(), m_ray_dy.data(), nRays, m_ray_range.data());
+
+		for (size_t i = 0; i < nRays; i++)
+			if (m_ray_range[i] <= maxRange)
+				fuseRange(i, m_ray_range[i] + randn(m_rnd) * m_rangeStdNoise);
 	}
-	m_world->getTimeLogger().leave("LaserScanner.scan.3.merge");
+	m_time_polygons += tictac.Tac();
 
 	{
 		std::lock_guard<std::mutex> csl(m_last_scan_cs);
 		m_last_scan = std::move(lastScan);
 		m_last_scan2gui = m_last_scan;
+		m_gui_uptodate = false;
 	}
+}
+
+void LaserScanner::simul_post_timestep_commit(const TSimulContext& context)
+{
+	SensorBase::simul_post_timestep_commit(context);
+
+	// The time logger is not thread-safe, so scans are timed on their own:
+	auto& tl = m_world->getTimeLogger();
+	tl.registerUserMeasure("LaserScanner.scan.1.gridmap", m_time_gridmap);
+	tl.registerUserMeasure("LaserScanner.scan.2.polygons", m_time_polygons);
 
 	SensorBase::reportNewObservation(m_last_scan, context);
+}
 
-	m_gui_uptodate = false;
+void LaserScanner::saveState(mrpt::serialization::CArchive& out) const
+{
+	SensorBase::saveState(out);
+
+	out << m_rnd.state();
+}
+
+void LaserScanner::restoreState(mrpt::serialization::CArchive& in)
+{
+	SensorBase::restoreState(in);
+
+	uint64_t rndState;
+	in >> rndState;
+	m_rnd.setState(rndState);
 }
@@ -0,0 +1,198 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include "ScanRayCaster.h"
+
+#include <Box2D/Collision/Shapes/b2ChainShape.h>
+#include <Box2D/Collision/Shapes/b2CircleShape.h>
+#include <Box2D/Collision/Shapes/b2EdgeShape.h>
+#include <Box2D/Collision/Shapes/b2PolygonShape.h>
+#include <Box2D/Dynamics/b2Fixture.h>
+#include <mvsim/basic_types.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace mvsim;
+
+void ScanRayCaster::Segments::clear()
+{
+	ax.clear();
+	ay.clear();
+	ex.clear();
+	ey.clear();
+}
+
+void ScanRayCaster::Segments::add(
+	const b2Vec2& a, const b2Vec2& b, double sx, double sy)
+{
+	ax.push_back(a.x - sx);
+	ay.push_back(a.y - sy);
+	ex.push_back(b.x - a.x);
+	ey.push_back(b.y - a.y);
+}
+
+class ScanRayCaster::QueryCallback : public b2QueryCallback
+{
+   public:
+	QueryCallback(
+		ScanRayCaster& rc, double sx, double sy, const b2Body* ignoreBody)
+		: m_rc(rc), m_sx(sx), m_sy(sy), m_ignore_body(ignoreBody)
+	{
+	}
+
+	bool ReportFixture(b2Fixture* f) override
+	{
+		if (f->GetUserData() == INVISIBLE_FIXTURE_USER_DATA ||
+			f->GetBody() == m_ignore_body)
+			return true;
+
+		const b2Transform& xf = f->GetBody()->GetTransform();
+		const b2Shape* shape = f->GetShape();
+
+		switch (shape->GetType())
+		{
+			case b2Shape::e_polygon:
+			{
+				const auto* poly = static_cast<const b2PolygonShape*>(shape);
+				const int32 n = poly->m_count;
+				b2Vec2 prev = b2Mul(xf, poly->m_vertices[n - 1]);
+				for (int32 i = 0; i < n; i++)
+				{
+					const b2Vec2 v = b2Mul(xf, poly->m_vertices[i]);
+					m_rc.m_one_sided.add(prev, v, m_sx, m_sy);
+					prev = v;
+				}
+			}
+			break;
+
+			case b2Shape::e_edge:
+			{
+				const auto* edge = static_cast<const b2EdgeShape*>(shape);
+				m_rc.m_two_sided.add(
+					b2Mul(xf, edge->m_vertex1), b2Mul(xf, edge->m_vertex2),
+					m_sx, m_sy);
+			}
+			break;
+
+			case b2Shape::e_chain:
+			{
+				// Reported once per child edge, but gathered all at once:
+				auto& chains = m_rc.m_chains;
+				if (std::find(chains.begin(), chains.end(), f) != chains.end())
+					break;
+				chains.push_back(f);
+
+				const auto* chain = static_cast<const b2ChainShape*>(shape);
+				for (int32 i = 0; i < chain->GetChildCount(); i++)
+				{
+					b2EdgeShape edge;
+					chain->GetChildEdge(&edge, i);
+					m_rc.m_two_sided.add(
+						b2Mul(xf, edge.m_vertex1), b2Mul(xf, edge.m_vertex2),
+						m_sx, m_sy);
+				}
+			}
+			break;
+
+			case b2Shape::e_circle:
+			{
+				const auto* circle = static_cast<const b2CircleShape*>(shape);
+				const b2Vec2 c = b2Mul(xf, circle->m_p);
+				m_rc.m_cx.push_back(c.x - m_sx);
+				m_rc.m_cy.push_back(c.y - m_sy);
+				m_rc.m_cr.push_back(circle->m_radius);
+			}
+			break;
+
+			default:
+				break;
+		};
+
+		return true;  // Go on with the next fixture
+	}
+
+   private:
+	ScanRayCaster& m_rc;
+	const double m_sx, m_sy;
+	const b2Body* m_ignore_body;
+};
+
+void ScanRayCaster::gather(
+	const b2World& world, double sx, double sy, double maxRange,
+	const b2Body* ignoreBody)
+{
+	m_max_range = maxRange;
+	m_one_sided.clear();
+	m_two_sided.clear();
+	m_cx.clear();
+	m_cy.clear();
+	m_cr.clear();
+	m_chains.clear();
+
+	b2AABB aabb;
+	aabb.lowerBound.Set(sx - maxRange, sy - maxRange);
+	aabb.upperBound.Set(sx + maxRange, sy + maxRange);
+
+	QueryCallback callback(*this, sx, sy, ignoreBody);
+	world.QueryAABB(&callback, aabb);
+}
+
+void ScanRayCaster::cast(
+	const double* dx, const double* dy, size_t nRays, double* outRange) const
+{
+	const double maxR = m_max_range;
+
+	std::fill(
+		outRange, outRange + nRays, std::numeric_limits<double>::infinity());
+
+	// Rays p=t*d hit segments a+u*e where t*d-u*e=a, with the denominator
+	// den=cross(d,e) being <0 when they enter counter-clockwise polygons.
+	// Loops over rays have no branches, so they are vectorized.
+	for (const Segments* segs : {&m_one_sided, &m_two_sided})
+	{
+		const bool oneSided = (segs == &m_one_sided);
+
+		for (size_t k = 0; k < segs->size(); k++)
+		{
+			const double ax = segs->ax[k], ay = segs->ay[k];
+			const double ex = segs->ex[k], ey = segs->ey[k];
+			const double tNum = ax * ey - ay * ex;
+
+			for (size_t i = 0; i < nRays; i++)
+			{
+				const double den = dx[i] * ey - dy[i] * ex;
+				const double t = tNum / den;
+				const double u = (dy[i] * ax - dx[i] * ay) / den;
+				const bool facing = oneSided ? den < 0 : den != 0;
+				const bool hit = facing && t >= 0 && t <= maxR && u >= 0 &&
+								 u <= 1 && t < outRange[i];
+				outRange[i] = hit ? t : outRange[i];
+			}
+		}
+	}
+
+	// Circles, as in b2CircleShape::RayCast():
+	for (size_t k = 0; k < m_cx.size(); k++)
+	{
+		const double cx = m_cx[k], cy = m_cy[k];
+		const double b = cx * cx + cy * cy - m_cr[k] * m_cr[k];
+
+		for (size_t i = 0; i < nRays; i++)
+		{
+			const double c = -(cx * dx[i] + cy * dy[i]);
+			const double sigma = c * c - b;
+			const double t = -c - std::sqrt(std::max(sigma, 0.0));
+			const bool hit =
+				sigma >= 0 && t >= 0 && t <= maxR && t < outRange[i];
+			outRange[i] = hit ? t : outRange[i];
+		}
+	}
+}
@@ -0,0 +1,73 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#pragma once
+
+#include <Box2D/Dynamics/b2World.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace mvsim
+{
+/** Casts all the rays of a 2D range scan at once against Box2D fixtures.
+ *
+ * gather() runs one AABB query over the range of the sensor, and keeps the
+ * edges of the fixtures found (polygons, edges and chains) and their circles,
+ * relative to the sensor. Then, cast() intersects each of them with all rays
+ * in a tight loop over rays.
+ *
+ * Hits are the same as those of b2World::RayCast() with a closest-hit
+ * callback: polygon edges only count when rays enter the polygon through
+ * them, so rays starting inside a polygon or circle do not hit it.
+ */
+class ScanRayCaster
+{
+   public:
+	/** Gathers the fixtures within \a maxRange of the sensor, at (sx,sy) in
+	 * global coordinates. Fixtures with INVISIBLE_FIXTURE_USER_DATA, or of
+	 * \a ignoreBody (e.g. the vehicle carrying the sensor), are ignored.
+	 * The world is not modified, so several sensors may gather at once. */
+	void gather(
+		const b2World& world, double sx, double sy, double maxRange,
+		const b2Body* ignoreBody = nullptr);
+
+	/** Sets outRange[i] to the distance from the sensor to the closest hit
+	 * along the unit direction (dx[i],dy[i]) (global coordinates), or to a
+	 * value larger than the maxRange of gather() if there is none. */
+	void cast(
+		const double* dx, const double* dy, size_t nRays,
+		double* outRange) const;
+
+	size_t segmentCount() const
+	{
+		return m_one_sided.size() + m_two_sided.size();
+	}
+
+   private:
+	/** Segments a+u*e (u in [0,1]), relative to the sensor */
+	struct Segments
+	{
+		std::vector<double> ax, ay, ex, ey;
+
+		size_t size() const { return ax.size(); }
+		void clear();
+		void add(const b2Vec2& a, const b2Vec2& b, double sx, double sy);
+	};
+
+	double m_max_range = 0;
+	Segments m_one_sided;  //!< Polygon edges, counter-clockwise
+	Segments m_two_sided;  //!< Edge and chain shapes
+	std::vector<double> m_cx, m_cy, m_cr;  //!< Circles
+	std::vector<const b2Fixture*> m_chains;	 //!< Already gathered
+
+	class QueryCallback;
+};
+
+}  // namespace mvsim
@@ -8,6 +8,7 @@
   +-------------------------------------------------------------------------+ */
 
 #include <mrpt/core/format.h>
+#include <mrpt/serialization/CArchive.h>
 #include <mvsim/Sensors/LaserScanner.h>
 #include <mvsim/VehicleBase.h>
 #include <mvsim/World.h>
@@ -26,6 +27,13 @@
 
 using namespace mvsim;
 
+struct SensorBase::PublishMsg
+{
+#if defined(MVSIM_HAS_ZMQ) && defined(MVSIM_HAS_PROTOBUF)
+	mvsim_msgs::GenericObservation msg;
+#endif
+};
+
 TClassFactory_sensors mvsim::classFactory_sensors;
 
 // Explicit registration calls seem to be one (the unique?) way to assure
@@ -112,17 +120,22 @@ void SensorBase::reportNewObservation(
 
 	// Publish:
 #if defined(MVSIM_HAS_ZMQ) && defined(MVSIM_HAS_PROTOBUF)
-	if (!publishTopic_.empty())
+	if (!publishTopic_.empty() && context.world->isConnectedToServer())
 	{
-		mvsim_msgs::GenericObservation msg;
-		msg.set_unixtimestamp(mrpt::Clock::toDouble(obs->timestamp));
-		msg.set_sourceobjectid(m_vehicle.getName());
+		// Serialized into a buffer and a message kept between observations,
+		// whose fields are only reallocated if they grow:
+		m_serialization_buf.Seek(0);
+		auto arch = mrpt::serialization::archiveFrom(m_serialization_buf);
+		arch.WriteObject(obs.get());
 
-		std::vector<uint8_t> serializedData;
-		mrpt::serialization::ObjectToOctetVector(obs.get(), serializedData);
+		if (!m_publish_msg) m_publish_msg = std::make_unique<PublishMsg>();
+		mvsim_msgs::GenericObservation& msg = m_publish_msg->msg;
 
-		msg.set_mrptserializedobservation(
-			serializedData.data(), serializedData.size());
+		msg.set_unixtimestamp(mrpt::Clock::toDouble(obs->timestamp));
+		msg.mutable_sourceobjectid()->assign(m_vehicle.getName());
+		msg.mutable_mrptserializedobservation()->assign(
+			static_cast<const char*>(m_serialization_buf.getRawBufferData()),
+			m_serialization_buf.getPosition());
 
 		context.world->commsClient().publishTopic(publishTopic_, msg);
 	}
@@ -136,7 +149,47 @@ void SensorBase::registerOnServer(mvsim::Client& c)
 
 #if defined(MVSIM_HAS_ZMQ) && defined(MVSIM_HAS_PROTOBUF)
 	// Topic:
-	if (!publishTopic_.empty())
+	if (!publishTopic_.empty() && !c.isTopicAdvertised(publishTopic_))
 		c.advertiseTopic<mvsim_msgs::GenericObservation>(publishTopic_);
 #endif
 }
+
+void SensorBase::registerPeriodicTasks(TaskScheduler& scheduler)
+{
+	Simulable::registerPeriodicTasks(scheduler);
+
+	scheduler.add_parallel(
+		m_sensor_period, m_sensor_last_timestamp + m_sensor_period,
+		[this](const TSimulContext& context) {
+			m_sensor_last_timestamp = context.simul_time;
+			Simulable::simul_post_timestep(context);
+			simul_sensor_snapshot(context);
+		},
+		[this](const TSimulContext& context) {
+			simul_sensor_compute(context);
+		},
+		[this](const TSimulContext& context) {
+			simul_post_timestep_commit(context);
+		},
+		m_vehicle.getName() + "/" + getName());
+}
+
+void SensorBase::simul_post_timestep(const TSimulContext& context)
+{
+	Simulable::simul_post_timestep(context);
+
+	simul_sensor_snapshot(context);
+	simul_sensor_compute(context);
+}
+
+void SensorBase::saveState(mrpt::serialization::CArchive& out) const
+{
+	Simulable::saveState(out);
+	out << m_sensor_last_timestamp;
+}
+
+void SensorBase::restoreState(mrpt::serialization::CArchive& in)
+{
+	Simulable::restoreState(in);
+	in >> m_sensor_last_timestamp;
+}
@@ -8,9 +8,11 @@
   +-------------------------------------------------------------------------+ */
 
 #include <Box2D/Dynamics/Contacts/b2Contact.h>
+#include <mrpt/serialization/CArchive.h>
 #include <mvsim/Comms/Client.h>
 #include <mvsim/Simulable.h>
 #include <mvsim/TParameterDefinitions.h>
+#include <mvsim/TaskScheduler.h>
 #include <mvsim/World.h>
 
 #include "xml_utils.h"
@@ -24,8 +26,17 @@ using namespace mvsim;
 
 void Simulable::simul_pre_timestep(	 //
 	[[maybe_unused]] const TSimulContext& context)
+{ /* default: do nothing*/
+}
+
+bool Simulable::simul_sync_b2d_body()
 {
-	if (!m_b2d_body) return;
+	// Only if changed externally, to avoid needlessly updating the Box2D
+	// broad-phase and to let bodies sleep:
+	const uint64_t version = m_q_version;
+	if (!m_b2d_body || version == m_q_synced_version) return false;
+
+	std::shared_lock lck(m_q_mtx);
 
 	// Pos:
 	m_b2d_body->SetTransform(b2Vec2(m_q.x, m_q.y), m_q.yaw);
@@ -33,6 +44,51 @@ void Simulable::simul_pre_timestep(	 //
 	// Vel:
 	m_b2d_body->SetLinearVelocity(b2Vec2(m_dq.vx, m_dq.vy));
 	m_b2d_body->SetAngularVelocity(m_dq.omega);
+
+	m_b2d_body->SetAwake(true);
+
+	m_q_synced_version = version;
+	return true;
+}
+
+bool Simulable::simul_is_idle() const
+{
+	if (!m_b2d_body || m_q_version != m_q_synced_version) return false;
+	if (simul_is_batched()) return true;
+
+	if (m_b2d_body->GetType() != b2_staticBody && m_b2d_body->IsAwake())
+		return false;
+
+	return simul_is_passive();
+}
+
+void Simulable::simul_pre_timestep_commit(bool hold)
+{
+	m_held_forces.clear();
+
+	if (m_b2d_body)
+	{
+		for (const auto& f : m_queued_forces)
+		{
+			m_b2d_body->ApplyForce(f.first, f.second, true /*wake up*/);
+
+			if (hold)
+				m_held_forces.emplace_back(
+					m_b2d_body->GetLocalVector(f.first),
+					m_b2d_body->GetLocalPoint(f.second));
+		}
+	}
+	m_queued_forces.clear();
+}
+
+void Simulable::simul_pre_timestep_recommit()
+{
+	if (!m_b2d_body) return;
+
+	for (const auto& f : m_held_forces)
+		m_b2d_body->ApplyForce(
+			m_b2d_body->GetWorldVector(f.first),
+			m_b2d_body->GetWorldPoint(f.second), true /*wake up*/);
 }
 
 void Simulable::simul_post_timestep(  //
@@ -70,9 +126,55 @@ void Simulable::simul_post_timestep(  //
 	m_hadCollisionFlag = m_hadCollisionFlag || m_isInCollision;
 
 	poses_mutex_unlock();
+}
 
+void Simulable::simul_post_timestep_commit(  //
+	[[maybe_unused]] const TSimulContext& context)
+{ /* default: do nothing*/
+}
+
+void Simulable::registerPeriodicTasks(TaskScheduler& scheduler)
+{
 	// Optional publish to topics:
-	internalHandlePublish(context);
+	if (!m_b2d_body || publishPoseTopic_.empty()) return;
+
+	scheduler.add(
+		publishPosePeriod_, 0 /*asap*/,
+		[this](const TSimulContext& context) {
+			internalHandlePublish(context);
+		},
+		m_name + ".publish_pose");
+}
+
+void Simulable::saveState(mrpt::serialization::CArchive& out) const
+{
+	std::shared_lock lck(m_q_mtx);
+
+	out << m_q.x << m_q.y << m_q.z << m_q.yaw << m_q.pitch << m_q.roll;
+	out << m_dq.vx << m_dq.vy << m_dq.omega;
+	out << m_isInCollision << m_hadCollisionFlag;
+
+	out << static_cast<uint32_t>(m_held_forces.size());
+	for (const auto& f : m_held_forces)
+		out << f.first.x << f.first.y << f.second.x << f.second.y;
+}
+
+void Simulable::restoreState(mrpt::serialization::CArchive& in)
+{
+	std::unique_lock lck(m_q_mtx);
+
+	in >> m_q.x >> m_q.y >> m_q.z >> m_q.yaw >> m_q.pitch >> m_q.roll;
+	in >> m_dq.vx >> m_dq.vy >> m_dq.omega;
+	in >> m_isInCollision >> m_hadCollisionFlag;
+	m_q_version++;
+
+	uint32_t nForces;
+	in >> nForces;
+	m_held_forces.resize(nForces);
+	for (auto& f : m_held_forces)
+		in >> f.first.x >> f.first.y >> f.second.x >> f.second.y;
+
+	m_queued_forces.clear();
 }
 
 void Simulable::apply_force(
@@ -121,14 +223,13 @@ void Simulable::internalHandlePublish(const TSimulContext& context)
 	std::shared_lock lck(m_q_mtx);
 
 	MRPT_START
-	if (publishPoseTopic_.empty()) return;
+	if (publishPoseTopic_.empty() || !context.world->isConnectedToServer())
+		return;
 
 	auto& client = context.world->commsClient();
 
+	// Rate limited by the scheduler, see registerPeriodicTasks()
 	const double tNow = mrpt::Clock::toDouble(mrpt::Clock::now());
-	if (tNow < publishPoseLastTime_ + publishPosePeriod_) return;
-
-	publishPoseLastTime_ = tNow;
 
 	mvsim_msgs::TimeStampedPose msg;
 	msg.set_unixtimestamp(tNow);
@@ -152,8 +253,8 @@ void Simulable::registerOnServer(mvsim::Client& c)
 	MRPT_START
 
 #if defined(MVSIM_HAS_ZMQ) && defined(MVSIM_HAS_PROTOBUF)
-	// Topic:
-	if (!publishPoseTopic_.empty())
+	// Topic (objects reused by World::spawn() may be registered again):
+	if (!publishPoseTopic_.empty() && !c.isTopicAdvertised(publishPoseTopic_))
 		c.advertiseTopic<mvsim_msgs::TimeStampedPose>(publishPoseTopic_);
 #endif
 
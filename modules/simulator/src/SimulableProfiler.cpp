@@ -0,0 +1,116 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mrpt/core/exceptions.h>
+#include <mvsim/SimulableProfiler.h>
+
+#include <algorithm>
+
+using namespace mvsim;
+
+const char* SimulableProfiler::phaseName(Phase p)
+{
+	switch (p)
+	{
+		case Phase::PreStep:
+			return "pre_timestep";
+		case Phase::PostStep:
+			return "post_timestep";
+		case Phase::PeriodicTask:
+			return "periodic_task";
+		case Phase::GuiUpdate:
+			return "gui_update";
+	};
+	THROW_EXCEPTION("Unknown phase");
+}
+
+void SimulableProfiler::clear()
+{
+	std::lock_guard<std::mutex> lck(m_gui_mtx);
+	for (auto& s : m_stats) s.clear();
+}
+
+void SimulableProfiler::clear(Phase phase)
+{
+	std::lock_guard<std::mutex> lck(m_gui_mtx);
+	m_stats[static_cast<size_t>(phase)].clear();
+}
+
+void SimulableProfiler::clearObject(size_t index)
+{
+	std::lock_guard<std::mutex> lck(m_gui_mtx);
+	for (const Phase p : {Phase::PreStep, Phase::PostStep, Phase::GuiUpdate})
+		if (auto& v = m_stats[static_cast<size_t>(p)]; index < v.size())
+			v[index] = Stats();
+}
+
+void SimulableProfiler::prepare(size_t numObjects, size_t numTasks)
+{
+	auto grow = [](std::vector<Stats>& v, size_t n) {
+		if (v.size() < n) v.resize(n);
+	};
+
+	grow(m_stats[static_cast<size_t>(Phase::PreStep)], numObjects);
+	grow(m_stats[static_cast<size_t>(Phase::PostStep)], numObjects);
+	grow(m_stats[static_cast<size_t>(Phase::PeriodicTask)], numTasks);
+}
+
+void SimulableProfiler::add(Phase phase, size_t index, double dt)
+{
+	auto& v = m_stats[static_cast<size_t>(phase)];
+
+	std::unique_lock<std::mutex> lck(m_gui_mtx, std::defer_lock);
+	if (phase == Phase::GuiUpdate)
+	{
+		lck.lock();
+		if (v.size() <= index) v.resize(index + 1);
+	}
+
+	// Objects created after the last prepare() are not profiled until the
+	// next timestep:
+	if (index >= v.size()) return;
+
+	Stats& s = v[index];
+	s.count++;
+	s.total += dt;
+	s.max = std::max(s.max, dt);
+}
+
+std::vector<SimulableProfiler::Entry> SimulableProfiler::getTopN(
+	size_t n, const std::function<std::string(Phase, size_t)>& nameOf) const
+{
+	std::lock_guard<std::mutex> lck(m_gui_mtx);
+
+	std::vector<Entry> all;
+	for (size_t p = 0; p < PHASE_COUNT; p++)
+	{
+		const auto phase = static_cast<Phase>(p);
+		for (size_t i = 0; i < m_stats[p].size(); i++)
+		{
+			if (!m_stats[p][i].count) continue;
+
+			Entry e;
+			e.name = nameOf(phase, i);
+			if (e.name.empty()) continue;
+			e.phase = phase;
+			e.stats = m_stats[p][i];
+			all.emplace_back(std::move(e));
+		}
+	}
+
+	n = std::min(n, all.size());
+	std::partial_sort(
+		all.begin(), all.begin() + n, all.end(),
+		[](const Entry& a, const Entry& b) {
+			return a.stats.total > b.stats.total;
+		});
+	all.resize(n);
+
+	return all;
+}
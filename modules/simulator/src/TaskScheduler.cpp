@@ -0,0 +1,186 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mrpt/core/exceptions.h>
+#include <mvsim/TaskScheduler.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace mvsim;
+
+// Must be a power of two:
+static constexpr size_t WHEEL_SIZE = 256;
+
+TaskScheduler::TaskScheduler() : m_wheel(WHEEL_SIZE) {}
+
+void TaskScheduler::clear(double dt, double simul_time)
+{
+	ASSERT_(dt > 0);
+
+	wait_pipelined();
+
+	m_tasks.clear();
+	for (auto& slot : m_wheel) slot.clear();
+
+	m_dt = dt;
+	m_next_step = static_cast<uint64_t>(std::llround(simul_time / dt));
+
+	m_last_run_count = 0;
+	m_total_run_count = 0;
+}
+
+void TaskScheduler::add(
+	double period, double first_time, const task_t& task,
+	const std::string& name)
+{
+	ASSERT_(task);
+
+	// Small tolerance so periods that are exact multiples of dt do not get
+	// rounded up by one step due to floating point errors:
+	const double eps = 1e-6;
+
+	Task t;
+	t.f = task;
+	t.name = name;
+	t.period_steps = static_cast<uint64_t>(
+		std::max(1.0, std::ceil(period / m_dt - eps)));
+
+	const double firstStep = std::ceil(first_time / m_dt - eps);
+	t.next_step = firstStep > m_next_step ? static_cast<uint64_t>(firstStep)
+										  : m_next_step;
+
+	m_tasks.emplace_back(std::move(t));
+	insertInWheel(m_tasks.size() - 1);
+}
+
+void TaskScheduler::add_parallel(
+	double period, double first_time, const task_t& snapshot,
+	const task_t& compute, const task_t& commit, const std::string& name)
+{
+	ASSERT_(compute);
+	add(period, first_time, snapshot, name);
+
+	Task& t = m_tasks.back();
+	t.compute = compute;
+	t.commit = commit;
+	t.parallel = true;
+}
+
+void TaskScheduler::setPipelined(const enqueue_t& enqueue)
+{
+	wait_pipelined();
+	m_enqueue = enqueue;
+}
+
+void TaskScheduler::wait_pipelined()
+{
+	if (m_pipelined.empty()) return;
+
+	// Wait for all, and rethrow any exception:
+	std::vector<std::future<void>> futures;
+	std::swap(futures, m_pipelined_futures);
+	std::vector<size_t> tasks;
+	std::swap(tasks, m_pipelined);
+
+	for (auto& f : futures) f.wait();
+	for (auto& f : futures) f.get();
+
+	for (const size_t idx : tasks)
+		if (const Task& t = m_tasks[idx]; t.commit)
+			t.commit(m_pipelined_context);
+}
+
+void TaskScheduler::insertInWheel(size_t taskIdx)
+{
+	const auto slot = m_tasks[taskIdx].next_step & (WHEEL_SIZE - 1);
+	m_wheel[slot].push_back(taskIdx);
+}
+
+size_t TaskScheduler::run_due_tasks(
+	const TSimulContext& context, SimulableProfiler* profiler,
+	const parallel_for_t& parallelFor)
+{
+	const uint64_t step = m_next_step++;
+
+	// Results of the previous pipelined tasks go first:
+	wait_pipelined();
+	const bool pipelined = isPipelined();
+
+	// Tasks with periods longer than the wheel share the slot with other
+	// tasks not due yet, which are just put back:
+	m_running.clear();
+	std::swap(m_running, m_wheel[step & (WHEEL_SIZE - 1)]);
+
+	// Keep the registration order among tasks due at the same step, for
+	// repeatibility:
+	std::sort(m_running.begin(), m_running.end());
+
+	const auto runTask = [&](size_t idx) {
+		const Task& t = m_tasks[idx];
+		const auto run = [&]() {
+			t.f(context);
+			if (t.parallel && !pipelined) t.compute(context);
+		};
+		if (profiler)
+			profiler->measure(SimulableProfiler::Phase::PeriodicTask, idx, run);
+		else
+			run();
+	};
+
+	// Parallel tasks first, all at once:
+	m_running_parallel.clear();
+	for (const size_t idx : m_running)
+	{
+		const Task& t = m_tasks[idx];
+		if (t.next_step == step && t.parallel)
+			m_running_parallel.push_back(idx);
+	}
+	if (parallelFor && m_running_parallel.size() > 1)
+		parallelFor(m_running_parallel.size(), [&](size_t k) {
+			runTask(m_running_parallel[k]);
+		});
+	else
+		for (const size_t idx : m_running_parallel) runTask(idx);
+
+	size_t nRun = 0;
+	for (const size_t idx : m_running)
+	{
+		Task& t = m_tasks[idx];
+		if (t.next_step == step)
+		{
+			if (!t.parallel)
+				runTask(idx);
+			else if (pipelined)
+				m_pipelined.push_back(idx);
+			else if (t.commit)
+				t.commit(context);
+			t.next_step += t.period_steps;
+			nRun++;
+		}
+		insertInWheel(idx);
+	}
+
+	// Computations from the snapshots just taken, in the background:
+	if (!m_pipelined.empty())
+	{
+		m_pipelined_context = context;
+		for (const size_t idx : m_pipelined)
+		{
+			const task_t& compute = m_tasks[idx].compute;
+			m_pipelined_futures.emplace_back(m_enqueue(
+				[this, &compute]() { compute(m_pipelined_context); }));
+		}
+	}
+
+	m_last_run_count = nRun;
+	m_total_run_count += nRun;
+
+	return nRun;
+}
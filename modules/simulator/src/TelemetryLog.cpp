@@ -0,0 +1,287 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mrpt/core/exceptions.h>
+#include <mvsim/TelemetryLog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+using namespace mvsim;
+
+static const char TELEMETRY_MAGIC[8] = {'M', 'V', 'S', 'I', 'M', 'T', 'L', 'M'};
+// Increment upon any change in the binary format:
+static const uint32_t TELEMETRY_FORMAT_VERSION = 1;
+
+static bool hostIsLittleEndian()
+{
+	const uint32_t one = 1;
+	uint8_t firstByte;
+	std::memcpy(&firstByte, &one, 1);
+	return firstByte == 1;
+}
+
+namespace
+{
+/** The background thread shared by all open TelemetryWriter objects. It
+ * only runs while there are open writers. This object is never destroyed,
+ * so writers closed from static destructors are safe. */
+class FlushThread
+{
+   public:
+	static FlushThread& Instance()
+	{
+		static FlushThread* o = new FlushThread();
+		return *o;
+	}
+
+	void add(TelemetryWriter* w)
+	{
+		std::lock_guard<std::mutex> lck(m_mtx);
+		m_writers.push_back(w);
+		if (!m_running)
+		{
+			// The former thread, if any, already left run():
+			if (m_thread.joinable()) m_thread.join();
+			m_thread = std::thread(&FlushThread::run, this);
+			m_running = true;
+		}
+	}
+
+	/** Once this returns, \a w is not being drained, nor will be again */
+	void remove(TelemetryWriter* w)
+	{
+		{
+			std::lock_guard<std::mutex> lck(m_mtx);
+			m_writers.erase(
+				std::remove(m_writers.begin(), m_writers.end(), w),
+				m_writers.end());
+			if (m_writers.empty()) m_cv.notify_one();
+		}
+		// Wait for its drain in course, if any:
+		std::lock_guard<std::mutex> lck(w->m_drain_mtx);
+	}
+
+   private:
+	FlushThread() = default;
+
+	std::mutex m_mtx;
+	std::condition_variable m_cv;
+	std::vector<TelemetryWriter*> m_writers;
+	std::thread m_thread;
+	bool m_running = false;
+
+	void run()
+	{
+		std::vector<TelemetryWriter*> writers;
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lck(m_mtx);
+				m_cv.wait_for(lck, std::chrono::milliseconds(10));
+				if (m_writers.empty())
+				{
+					m_running = false;
+					return;
+				}
+				writers = m_writers;
+			}
+
+			// Disk writes, without blocking add() or remove() of others:
+			for (auto* w : writers)
+			{
+				std::unique_lock<std::mutex> wLck;
+				{
+					std::lock_guard<std::mutex> lck(m_mtx);
+					// Removed meanwhile?
+					if (std::find(m_writers.begin(), m_writers.end(), w) ==
+						m_writers.end())
+						continue;
+					wLck = std::unique_lock<std::mutex>(w->m_drain_mtx);
+				}
+				w->drain();
+			}
+		}
+	}
+};
+}  // namespace
+
+TelemetryWriter::TelemetryWriter(size_t ringRows, size_t blockRows)
+	: m_ringRows(ringRows), m_blockRows(blockRows)
+{
+	ASSERT_(ringRows > 0 && blockRows > 0);
+}
+
+TelemetryWriter::~TelemetryWriter() { close(); }
+
+bool TelemetryWriter::open(
+	const std::string& fileName, const std::vector<std::string>& columns)
+{
+	close();
+
+	ASSERTMSG_(
+		hostIsLittleEndian(),
+		"Binary telemetry logs are only supported in little-endian hosts");
+
+	m_file.open(fileName, std::ios::binary | std::ios::trunc);
+	if (!m_file.is_open()) return false;
+
+	m_nCols = columns.size();
+
+	const auto writeU32 = [this](uint32_t v) {
+		m_file.write(reinterpret_cast<const char*>(&v), sizeof(v));
+	};
+
+	m_file.write(TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC));
+	writeU32(TELEMETRY_FORMAT_VERSION);
+	writeU32(static_cast<uint32_t>(m_nCols));
+	for (const auto& c : columns)
+	{
+		writeU32(static_cast<uint32_t>(c.size()));
+		m_file.write(c.data(), c.size());
+	}
+
+	m_ring.assign(m_ringRows * m_nCols, 0.0);
+	m_ringHead = 0;
+	m_ringTail = 0;
+	m_block.assign(m_blockRows * m_nCols, 0.0);
+	m_blockUsed = 0;
+
+	FlushThread::Instance().add(this);
+	return true;
+}
+
+void TelemetryWriter::close()
+{
+	if (!m_file.is_open()) return;
+
+	FlushThread::Instance().remove(this);
+
+	// Rows still in the ring buffer, and the last partial block:
+	drain();
+	writeBlock();
+
+	m_file.close();
+}
+
+void TelemetryWriter::push(const double* row)
+{
+	const size_t head = m_ringHead.load(std::memory_order_relaxed);
+	const size_t next = (head + 1) % m_ringRows;
+
+	if (next == m_ringTail.load(std::memory_order_acquire))
+	{
+		m_stalls++;
+		while (next == m_ringTail.load(std::memory_order_acquire))
+			std::this_thread::yield();
+	}
+
+	std::copy(row, row + m_nCols, m_ring.data() + head * m_nCols);
+	m_ringHead.store(next, std::memory_order_release);
+}
+
+void TelemetryWriter::drain()
+{
+	size_t tail = m_ringTail.load(std::memory_order_relaxed);
+	const size_t head = m_ringHead.load(std::memory_order_acquire);
+
+	while (tail != head)
+	{
+		// Transpose into the column-major block:
+		const double* row = m_ring.data() + tail * m_nCols;
+		for (size_t c = 0; c < m_nCols; c++)
+			m_block[c * m_blockRows + m_blockUsed] = row[c];
+
+		tail = (tail + 1) % m_ringRows;
+		if (++m_blockUsed == m_blockRows)
+		{
+			// Free ring slots before the (slow) disk write:
+			m_ringTail.store(tail, std::memory_order_release);
+			writeBlock();
+		}
+	}
+	m_ringTail.store(tail, std::memory_order_release);
+}
+
+void TelemetryWriter::writeBlock()
+{
+	if (!m_blockUsed) return;
+
+	const auto nRows = static_cast<uint32_t>(m_blockUsed);
+	m_file.write(reinterpret_cast<const char*>(&nRows), sizeof(nRows));
+	for (size_t c = 0; c < m_nCols; c++)
+		m_file.write(
+			reinterpret_cast<const char*>(m_block.data() + c * m_blockRows),
+			sizeof(double) * m_blockUsed);
+
+	m_blockUsed = 0;
+}
+
+void TelemetryReader::open(const std::string& fileName)
+{
+	ASSERTMSG_(
+		hostIsLittleEndian(),
+		"Binary telemetry logs are only supported in little-endian hosts");
+
+	m_file.close();
+	m_file.clear();
+	m_file.open(fileName, std::ios::binary);
+	if (!m_file.is_open())
+		THROW_EXCEPTION_FMT("Error opening file '%s'", fileName.c_str());
+
+	const auto readU32 = [this]() {
+		uint32_t v = 0;
+		m_file.read(reinterpret_cast<char*>(&v), sizeof(v));
+		return v;
+	};
+
+	char magic[sizeof(TELEMETRY_MAGIC)];
+	m_file.read(magic, sizeof(magic));
+	if (!m_file || std::memcmp(magic, TELEMETRY_MAGIC, sizeof(magic)) != 0)
+		THROW_EXCEPTION_FMT(
+			"'%s' is not a binary telemetry log", fileName.c_str());
+
+	const uint32_t version = readU32();
+	ASSERT_EQUAL_(version, TELEMETRY_FORMAT_VERSION);
+
+	m_columns.resize(readU32());
+	for (auto& c : m_columns)
+	{
+		c.resize(readU32());
+		m_file.read(&c[0], c.size());
+	}
+	if (!m_file)
+		THROW_EXCEPTION_FMT("Truncated header in file '%s'", fileName.c_str());
+}
+
+bool TelemetryReader::readBlock(std::vector<std::vector<double>>& columns)
+{
+	uint32_t nRows = 0;
+	if (!m_file.read(reinterpret_cast<char*>(&nRows), sizeof(nRows)))
+		return false;
+
+	columns.resize(m_columns.size());
+	for (auto& c : columns)
+	{
+		c.resize(nRows);
+		m_file.read(reinterpret_cast<char*>(c.data()), sizeof(double) * nRows);
+	}
+
+	// A partial last block may be found if the writer did not close the file
+	if (!m_file)
+	{
+		columns.clear();
+		return false;
+	}
+	return true;
+}
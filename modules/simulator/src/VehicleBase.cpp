@@ -11,12 +11,16 @@
 #include <mrpt/math/TPose2D.h>
 #include <mrpt/opengl/CPolyhedron.h>
 #include <mrpt/poses/CPose2D.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/string_utils.h>
 #include <mvsim/FrictionModels/DefaultFriction.h>  // For use as default model
 #include <mvsim/FrictionModels/FrictionBase.h>
 #include <mvsim/VehicleBase.h>
 #include <mvsim/VehicleDynamics/VehicleAckermann.h>
 #include <mvsim/VehicleDynamics/VehicleAckermann_Drivetrain.h>
 #include <mvsim/VehicleDynamics/VehicleDifferential.h>
+#include <mvsim/VehicleDynamics/VehicleKinematicLite.h>
+#include <mvsim/VehicleDynamics/VehicleSpecialized.h>
 #include <mvsim/World.h>
 
 #include <map>
@@ -27,6 +31,7 @@
 #include <string>
 
 #include "JointXMLnode.h"
+#include "VehicleBase_impl.h"
 #include "XMLClassesRegistry.h"
 #include "xml_utils.h"
 
@@ -51,6 +56,7 @@ void register_all_veh_dynamics()
 	REGISTER_VEHICLE_DYNAMICS("ackermann", DynamicsAckermann)
 	REGISTER_VEHICLE_DYNAMICS(
 		"ackermann_drivetrain", DynamicsAckermannDrivetrain)
+	REGISTER_VEHICLE_DYNAMICS("kinematic_lite", DynamicsKinematicLite)
 }
 
 constexpr char VehicleBase::DL_TIMESTAMP[];
@@ -119,6 +125,11 @@ void VehicleBase::register_vehicle_class(
 	veh_classes_registry.add(ss.str());
 }
 
+bool VehicleBase::is_registered_class(const std::string& name)
+{
+	return veh_classes_registry.get(name) != nullptr;
+}
+
 /** Class factory: Creates a vehicle from XML description of type
  * "<vehicle>...</vehicle>".  */
 VehicleBase::Ptr VehicleBase::factory(
@@ -175,8 +186,17 @@ VehicleBase::Ptr VehicleBase::factory(
 			"[VehicleBase::factory] Missing mandatory attribute 'class' in "
 			"node <dynamics>");
 
+	// Use a compile-time specialized vehicle if there is one for this
+	// combination of dynamics and controller classes:
+	std::string ctrlClass;	// Empty: the default one of the dynamics class
+	if (const xml_node<>* n = dyn_node->first_node("controller"); n)
+		if (const xml_attribute<>* c = n->first_attribute("class"); c)
+			ctrlClass = c->value();
+
 	VehicleBase::Ptr veh =
-		classFactory_vehicleDynamics.create(dyn_class->value(), parent);
+		createSpecializedVehicle(parent, dyn_class->value(), ctrlClass);
+	if (!veh)
+		veh = classFactory_vehicleDynamics.create(dyn_class->value(), parent);
 	if (!veh)
 		throw runtime_error(mrpt::format(
 			"[VehicleBase::factory] Unknown vehicle dynamics class '%s'",
@@ -282,6 +302,21 @@ VehicleBase::Ptr VehicleBase::factory(
 			// Parse:
 			veh->m_log_path = log_path_node->value();
 		}
+
+		// "csv" (default) or "binary", for high-rate logging:
+		const xml_node<>* log_fmt_node = veh_root_node.first_node("log_format");
+		if (log_fmt_node)
+		{
+			const std::string fmt = mrpt::system::trim(log_fmt_node->value());
+			if (fmt == "binary")
+				veh->m_log_format = CSVLogger::Format::Binary;
+			else if (fmt == "csv")
+				veh->m_log_format = CSVLogger::Format::CSV;
+			else
+				THROW_EXCEPTION_FMT(
+					"Invalid <log_format>: '%s' (valid: csv, binary)",
+					fmt.c_str());
+		}
 	}
 
 	veh->initLoggers();
@@ -320,6 +355,9 @@ VehicleBase::Ptr VehicleBase::factory(
 				FrictionBase::factory(*veh, frict_node));
 			ASSERT_(veh->m_friction);
 		}
+
+		for (auto& logger : veh->m_wheel_loggers)
+			veh->m_friction->registerLogColumns(*logger);
 	}
 
 	// Sensors: <sensor class='XXX'> entries
@@ -362,99 +400,95 @@ VehicleBase::Ptr VehicleBase::factory(
 
 void VehicleBase::simul_pre_timestep(const TSimulContext& context)
 {
-	Simulable::simul_pre_timestep(context);
-	for (auto& s : m_sensors) s->simul_pre_timestep(context);
-
-	// Update wheels position (they may turn, etc. as in an Ackermann
-	// configuration)
-	for (size_t i = 0; i < m_fixture_wheels.size(); i++)
-	{
-		b2PolygonShape* wheelShape =
-			dynamic_cast<b2PolygonShape*>(m_fixture_wheels[i]->GetShape());
-		wheelShape->SetAsBox(
-			m_wheels_info[i].diameter * 0.5, m_wheels_info[i].width * 0.5,
-			b2Vec2(m_wheels_info[i].x, m_wheels_info[i].y),
-			m_wheels_info[i].yaw);
-	}
-
-	// Apply motor forces/torques:
-	this->invoke_motor_controllers(context, m_torque_per_wheel);
-
-	// Apply friction model at each wheel:
-	const size_t nW = getNumWheels();
-	ASSERT_EQUAL_(m_torque_per_wheel.size(), nW);
-
-	const double gravity = getWorldObject()->get_gravity();
-	const double massPerWheel =
-		getChassisMass() / nW;  // Part of the vehicle weight on each wheel.
-	const double weightPerWheel = massPerWheel * gravity;
+	internal_simul_pre_timestep<0>(
+		context, [this](const TSimulContext& c, std::vector<double>& torques) {
+			invoke_motor_controllers(c, torques);
+		});
+}
 
-	std::vector<mrpt::math::TPoint2D> wheels_vels;
-	getWheelsVelocityLocal(wheels_vels, getVelocityLocal());
+bool VehicleBase::getFrictionBatchParams(FrictionBatchParams& p) const
+{
+	return m_friction && m_friction->getBatchParams(p);
+}
 
-	ASSERT_EQUAL_(wheels_vels.size(), nW);
+void VehicleBase::apply_batched_friction(const TSimulContext& context)
+{
+	ASSERT_(m_friction_batch);
+	const FrictionBatch& b = *m_friction_batch;
 
 	std::vector<mrpt::math::TSegment3D>
 		force_vectors;  // For visualization only
 
+	const size_t nW = getNumWheels();
 	for (size_t i = 0; i < nW; i++)
 	{
-		// prepare data:
 		Wheel& w = getWheelInfo(i);
+		const size_t k = m_friction_batch_first + i;
+
+		w.setW(b.w[k]);
 
 		FrictionBase::TFrictionInput fi(context, w);
-		fi.motor_torque =
-			-m_torque_per_wheel[i];  // "-" => Forwards is negative
-		fi.weight = weightPerWheel;
-		fi.wheel_speed = wheels_vels[i];
-
-		m_friction->setLogger(
-			getLoggerPtr(LOGGER_WHEEL + std::to_string(i + 1)));
-		// eval friction:
-		mrpt::math::TPoint2D net_force_;
-		m_friction->evaluate_friction(fi, net_force_);
-
-		// Apply force:
-		const b2Vec2 wForce = m_b2d_body->GetWorldVector(b2Vec2(
-			net_force_.x, net_force_.y));  // Force vector -> world coords
-		const b2Vec2 wPt = m_b2d_body->GetWorldPoint(
-			b2Vec2(w.x, w.y));  // Application point -> world coords
-		// printf("w%i: Lx=%6.3f Ly=%6.3f  | Gx=%11.9f
-		// Gy=%11.9f\n",(int)i,net_force_.x,net_force_.y,wForce.x,wForce.y);
-
-		m_b2d_body->ApplyForce(wForce, wPt, true /*wake up*/);
-
-		// log
-		{
-			m_loggers[LOGGER_WHEEL + std::to_string(i + 1)]->updateColumn(
-				DL_TIMESTAMP, context.simul_time);
-			m_loggers[LOGGER_WHEEL + std::to_string(i + 1)]->updateColumn(
-				WL_TORQUE, fi.motor_torque);
-			m_loggers[LOGGER_WHEEL + std::to_string(i + 1)]->updateColumn(
-				WL_WEIGHT, fi.weight);
-			m_loggers[LOGGER_WHEEL + std::to_string(i + 1)]->updateColumn(
-				WL_VEL_X, fi.wheel_speed.x);
-			m_loggers[LOGGER_WHEEL + std::to_string(i + 1)]->updateColumn(
-				WL_VEL_Y, fi.wheel_speed.y);
-			m_loggers[LOGGER_WHEEL + std::to_string(i + 1)]->updateColumn(
-				WL_FRIC_X, net_force_.x);
-			m_loggers[LOGGER_WHEEL + std::to_string(i + 1)]->updateColumn(
-				WL_FRIC_Y, net_force_.y);
-		}
+		fi.motor_torque = b.torque[k];
+		fi.weight = b.weight[k];
+		fi.wheel_speed = mrpt::math::TPoint2D(b.vel_x[k], b.vel_y[k]);
 
-		// save it for optional rendering:
-		if (m_world->m_gui_options.show_forces)
-		{
-			const double forceScale =
-				m_world->m_gui_options.force_scale;  // [meters/N]
-			const mrpt::math::TPoint3D pt1(
-				wPt.x, wPt.y, m_chassis_z_max * 1.1 + getPose().z);
-			const mrpt::math::TPoint3D pt2 =
-				pt1 + mrpt::math::TPoint3D(wForce.x, wForce.y, 0) * forceScale;
-			force_vectors.push_back(mrpt::math::TSegment3D(pt1, pt2));
-		}
+		internal_apply_wheel_friction(
+			fi, i, mrpt::math::TPoint2D(b.force_x[k], b.force_y[k]),
+			force_vectors);
+
+		CSVLogger& logger = *m_wheel_loggers[i];
+		if (logger.isRecording()) m_friction->logBatchOutputs(logger, b, k);
+	}
+
+	internal_save_force_vectors(force_vectors);
+}
+
+void VehicleBase::internal_apply_wheel_friction(
+	const FrictionBase::TFrictionInput& fi, size_t wheelIndex,
+	const mrpt::math::TPoint2D& net_force,
+	std::vector<mrpt::math::TSegment3D>& force_vectors)
+{
+	const Wheel& w = fi.wheel;
+
+	// Apply force:
+	const b2Vec2 wForce = m_b2d_body->GetWorldVector(
+		b2Vec2(net_force.x, net_force.y));  // Force vector -> world coords
+	const b2Vec2 wPt = m_b2d_body->GetWorldPoint(
+		b2Vec2(w.x, w.y));  // Application point -> world coords
+
+	// (Applied to Box2D in simul_pre_timestep_commit())
+	queueForce(wForce, wPt);
+
+	// log
+	CSVLogger& logger = *m_wheel_loggers[wheelIndex];
+	if (logger.isRecording())
+	{
+		const auto& wc = m_wheel_log_cols;
+		logger.updateColumn(wc.timestamp, fi.context.simul_time);
+		logger.updateColumn(wc.torque, fi.motor_torque);
+		logger.updateColumn(wc.weight, fi.weight);
+		logger.updateColumn(wc.vel_x, fi.wheel_speed.x);
+		logger.updateColumn(wc.vel_y, fi.wheel_speed.y);
+		logger.updateColumn(wc.fric_x, net_force.x);
+		logger.updateColumn(wc.fric_y, net_force.y);
 	}
 
+	// save it for optional rendering:
+	if (m_world->m_gui_options.show_forces)
+	{
+		const double forceScale =
+			m_world->m_gui_options.force_scale;  // [meters/N]
+		const mrpt::math::TPoint3D pt1(
+			wPt.x, wPt.y, m_chassis_z_max * 1.1 + getPose().z);
+		const mrpt::math::TPoint3D pt2 =
+			pt1 + mrpt::math::TPoint3D(wForce.x, wForce.y, 0) * forceScale;
+		force_vectors.push_back(mrpt::math::TSegment3D(pt1, pt2));
+	}
+}
+
+void VehicleBase::internal_save_force_vectors(
+	const std::vector<mrpt::math::TSegment3D>& force_vectors)
+{
 	// Save forces for optional rendering:
 	if (m_world->m_gui_options.show_forces)
 	{
@@ -469,7 +503,6 @@ void VehicleBase::simul_post_timestep(const TSimulContext& context)
 {
 	// Common part (update m_q, m_dq)
 	Simulable::simul_post_timestep(context);
-	for (auto& s : m_sensors) s->simul_post_timestep(context);
 
 	// Integrate wheels' rotation:
 	const size_t nW = getNumWheels();
@@ -492,23 +525,77 @@ void VehicleBase::simul_post_timestep(const TSimulContext& context)
 				(w.getPhi() < 0.0 ? -1.0 : 1.0));
 	}
 
-	const auto q = getPose();
-	const auto dq = getTwist();
+	if (m_pose_logger->isRecording())
+	{
+		const auto q = getPose();
+		const auto dq = getTwist();
+		const auto& pc = m_pose_log_cols;
+
+		m_pose_logger->updateColumn(pc.timestamp, context.simul_time);
+		m_pose_logger->updateColumn(pc.q_x, q.x);
+		m_pose_logger->updateColumn(pc.q_y, q.y);
+		m_pose_logger->updateColumn(pc.q_z, q.z);
+		m_pose_logger->updateColumn(pc.q_yaw, q.yaw);
+		m_pose_logger->updateColumn(pc.q_pitch, q.pitch);
+		m_pose_logger->updateColumn(pc.q_roll, q.roll);
+		m_pose_logger->updateColumn(pc.dq_x, dq.vx);
+		m_pose_logger->updateColumn(pc.dq_y, dq.vy);
+		m_pose_logger->updateColumn(pc.dq_z, dq.omega);
+	}
+
+	writeLogStrings();
+}
+
+void VehicleBase::saveState(mrpt::serialization::CArchive& out) const
+{
+	Simulable::saveState(out);
+
+	out << static_cast<uint32_t>(m_wheels_info.size());
+	for (const auto& w : m_wheels_info) out << w.yaw << w.getPhi() << w.getW();
+
+	// const_cast: getControllerInterface() is not const, but we only read:
+	if (auto* c = const_cast<VehicleBase*>(this)->getControllerInterface(); c)
+		c->saveState(out);
+
+	out << static_cast<uint32_t>(m_sensors.size());
+	for (const auto& s : m_sensors) s->saveState(out);
 
-	m_loggers[LOGGER_POSE]->updateColumn(DL_TIMESTAMP, context.simul_time);
-	m_loggers[LOGGER_POSE]->updateColumn(PL_Q_X, q.x);
-	m_loggers[LOGGER_POSE]->updateColumn(PL_Q_Y, q.y);
-	m_loggers[LOGGER_POSE]->updateColumn(PL_Q_Z, q.z);
-	m_loggers[LOGGER_POSE]->updateColumn(PL_Q_YAW, q.yaw);
-	m_loggers[LOGGER_POSE]->updateColumn(PL_Q_PITCH, q.pitch);
-	m_loggers[LOGGER_POSE]->updateColumn(PL_Q_ROLL, q.roll);
-	m_loggers[LOGGER_POSE]->updateColumn(PL_DQ_X, dq.vx);
-	m_loggers[LOGGER_POSE]->updateColumn(PL_DQ_Y, dq.vy);
-	m_loggers[LOGGER_POSE]->updateColumn(PL_DQ_Z, dq.omega);
+	out << static_cast<uint32_t>(getLODLevel()) << m_lod_next_step;
+}
+
+void VehicleBase::restoreState(mrpt::serialization::CArchive& in)
+{
+	Simulable::restoreState(in);
 
+	uint32_t n;
+	in >> n;
+	ASSERT_EQUAL_(n, m_wheels_info.size());
+	for (auto& w : m_wheels_info)
 	{
-		writeLogStrings();
+		double phi, ww;
+		in >> w.yaw >> phi >> ww;
+		w.setPhi(phi);
+		w.setW(ww);
 	}
+
+	if (auto* c = getControllerInterface(); c) c->restoreState(in);
+
+	in >> n;
+	ASSERT_EQUAL_(n, m_sensors.size());
+	for (auto& s : m_sensors) s->restoreState(in);
+
+	uint32_t lodLevel;
+	in >> lodLevel >> m_lod_next_step;
+	setLODLevel(lodLevel);
+}
+
+void VehicleBase::registerPeriodicTasks(TaskScheduler& scheduler)
+{
+	Simulable::registerPeriodicTasks(scheduler);
+
+	// Sensors run as parallel periodic tasks, all together after the
+	// physics step (see SensorBase::registerPeriodicTasks()):
+	for (auto& s : m_sensors) s->registerPeriodicTasks(scheduler);
 }
 
 /** Last time-step velocity of each wheel's center point (in local coords) */
@@ -539,6 +626,41 @@ mrpt::poses::CPose3D VehicleBase::internalGuiGetVisualPose()
 	return mrpt::poses::CPose3D(getPose());
 }
 
+void VehicleBase::guiRemove(mrpt::opengl::COpenGLScene& scene)
+{
+	VisualObject::guiRemove(scene);
+	for (auto& s : m_sensors) s->guiRemove(scene);
+}
+
+void VehicleBase::recycleAs(
+	const std::string& name, const std::string& className)
+{
+	const rapidxml::xml_node<char>* class_root =
+		veh_classes_registry.get(className);
+	ASSERTMSG_(
+		class_root,
+		mrpt::format("Vehicle class '%s' undefined", className.c_str()));
+
+	m_name = name;
+	parseSimulable(class_root->first_node("publish"));
+
+	// Files of the former name are closed, the new ones are created upon
+	// the next row:
+	for (auto& logger : m_loggers) logger.second->close();
+	setLoggersFilepath();
+
+	// Spawned vehicles only have the sensors of their class, in the same
+	// order (see factory()):
+	size_t i = 0;
+	for (const rapidxml::xml_node<char>* n = class_root->first_node("sensor");
+		 n; n = n->next_sibling("sensor"))
+	{
+		ASSERT_LT_(i, m_sensors.size());
+		m_sensors[i++]->loadConfigFrom(n);
+	}
+	ASSERT_EQUAL_(i, m_sensors.size());
+}
+
 void VehicleBase::internal_internalGuiUpdate_sensors(
 	mrpt::opengl::COpenGLScene& scene)
 {
@@ -624,6 +746,7 @@ void VehicleBase::create_multibody_system(b2World& world)
 	// Define shape of wheels:
 	// ------------------------------
 	ASSERT_EQUAL_(m_fixture_wheels.size(), m_wheels_info.size());
+	m_wheel_shapes.assign(m_wheels_info.size(), nullptr);
 
 	for (size_t i = 0; i < m_wheels_info.size(); i++)
 	{
@@ -648,6 +771,9 @@ void VehicleBase::create_multibody_system(b2World& world)
 		fixtureDef.friction = 0.5f;
 
 		m_fixture_wheels[i] = m_b2d_body->CreateFixture(&fixtureDef);
+		// Box2D stores a copy of wheelShape, so it is a b2PolygonShape too:
+		m_wheel_shapes[i] =
+			static_cast<b2PolygonShape*>(m_fixture_wheels[i]->GetShape());
 	}
 }
 
@@ -681,7 +807,19 @@ void VehicleBase::internalGuiUpdate(
 			gl_poly->setColor_u8(m_chassis_color);
 			m_gl_chassis->insert(gl_poly);
 
-			scene.insert(m_gl_chassis);
+			guiInsert(scene, m_gl_chassis);
+		}
+
+		// Level of detail, see World::TLODOptions:
+		if (m_world->m_lod_options.enabled() && !simul_is_batched())
+		{
+			if (!m_gl_lod)
+			{
+				m_gl_lod = mrpt::opengl::CText::Create();
+				m_gl_lod->setLocation(0, 0, m_chassis_z_max + 0.3);
+				m_gl_chassis->insert(m_gl_lod);
+			}
+			m_gl_lod->setString(mrpt::format("LOD %u", getLODLevel()));
 		}
 
 		// Update them:
@@ -703,7 +841,7 @@ void VehicleBase::internalGuiUpdate(
 		m_gl_forces = mrpt::opengl::CSetOfLines::Create();
 		m_gl_forces->setLineWidth(3.0);
 		m_gl_forces->setColor_u8(0xff, 0xff, 0xff);
-		scene.insert(m_gl_forces);  // forces are in global coords
+		guiInsert(scene, m_gl_forces);  // forces are in global coords
 	}
 
 	// Other common stuff:
@@ -713,42 +851,57 @@ void VehicleBase::internalGuiUpdate(
 
 void VehicleBase::initLoggers()
 {
-	m_loggers[LOGGER_POSE] = std::make_shared<CSVLogger>();
-	//  m_loggers[LOGGER_POSE]->addColumn(DL_TIMESTAMP);
-	//  m_loggers[LOGGER_POSE]->addColumn(PL_Q_X);
-	//  m_loggers[LOGGER_POSE]->addColumn(PL_Q_Y);
-	//  m_loggers[LOGGER_POSE]->addColumn(PL_Q_Z);
-	//  m_loggers[LOGGER_POSE]->addColumn(PL_Q_YAW);
-	//  m_loggers[LOGGER_POSE]->addColumn(PL_Q_PITCH);
-	//  m_loggers[LOGGER_POSE]->addColumn(PL_Q_ROLL);
-	//  m_loggers[LOGGER_POSE]->addColumn(PL_DQ_X);
-	//  m_loggers[LOGGER_POSE]->addColumn(PL_DQ_Y);
-	//  m_loggers[LOGGER_POSE]->addColumn(PL_DQ_Z);
-	m_loggers[LOGGER_POSE]->setFilepath(
-		m_log_path + "mvsim_" + m_name + LOGGER_POSE + ".log");
-
+	m_pose_logger = std::make_shared<CSVLogger>();
+	m_pose_logger->setFormat(m_log_format);
+	m_loggers[LOGGER_POSE] = m_pose_logger;
+
+	auto& pc = m_pose_log_cols;
+	pc.timestamp = m_pose_logger->addColumn(DL_TIMESTAMP);
+	pc.q_x = m_pose_logger->addColumn(PL_Q_X);
+	pc.q_y = m_pose_logger->addColumn(PL_Q_Y);
+	pc.q_z = m_pose_logger->addColumn(PL_Q_Z);
+	pc.q_yaw = m_pose_logger->addColumn(PL_Q_YAW);
+	pc.q_pitch = m_pose_logger->addColumn(PL_Q_PITCH);
+	pc.q_roll = m_pose_logger->addColumn(PL_Q_ROLL);
+	pc.dq_x = m_pose_logger->addColumn(PL_DQ_X);
+	pc.dq_y = m_pose_logger->addColumn(PL_DQ_Y);
+	pc.dq_z = m_pose_logger->addColumn(PL_DQ_Z);
+
+	m_wheel_loggers.clear();
 	for (size_t i = 0; i < getNumWheels(); i++)
 	{
-		m_loggers[LOGGER_WHEEL + std::to_string(i + 1)] =
-			std::make_shared<CSVLogger>();
-		//    m_loggers[LOGGER_WHEEL + std::to_string(i +
-		//    1)]->addColumn(DL_TIMESTAMP);
-		//    m_loggers[LOGGER_WHEEL + std::to_string(i +
-		//    1)]->addColumn(WL_TORQUE);
-		//    m_loggers[LOGGER_WHEEL + std::to_string(i +
-		//    1)]->addColumn(WL_WEIGHT);
-		//    m_loggers[LOGGER_WHEEL + std::to_string(i +
-		//    1)]->addColumn(WL_VEL_X);
-		//    m_loggers[LOGGER_WHEEL + std::to_string(i +
-		//    1)]->addColumn(WL_VEL_Y);
-		//    m_loggers[LOGGER_WHEEL + std::to_string(i +
-		//    1)]->addColumn(WL_FRIC_X);
-		//    m_loggers[LOGGER_WHEEL + std::to_string(i +
-		//    1)]->addColumn(WL_FRIC_Y);
-		m_loggers[LOGGER_WHEEL + std::to_string(i + 1)]->setFilepath(
-			m_log_path + "mvsim_" + m_name + LOGGER_WHEEL +
-			std::to_string(i + 1) + ".log");
+		auto logger = std::make_shared<CSVLogger>();
+		logger->setFormat(m_log_format);
+		m_wheel_loggers.push_back(logger);
+		m_loggers[LOGGER_WHEEL + std::to_string(i + 1)] = logger;
+
+		// All wheels have the same columns, hence the same handles:
+		auto& wc = m_wheel_log_cols;
+		wc.timestamp = logger->addColumn(DL_TIMESTAMP);
+		wc.torque = logger->addColumn(WL_TORQUE);
+		wc.weight = logger->addColumn(WL_WEIGHT);
+		wc.vel_x = logger->addColumn(WL_VEL_X);
+		wc.vel_y = logger->addColumn(WL_VEL_Y);
+		wc.fric_x = logger->addColumn(WL_FRIC_X);
+		wc.fric_y = logger->addColumn(WL_FRIC_Y);
 	}
+
+	setLoggersFilepath();
+}
+
+void VehicleBase::setLoggersFilepath()
+{
+	const std::string ext =
+		m_log_format == CSVLogger::Format::Binary ? ".bin" : ".log";
+
+	if (m_pose_logger)
+		m_pose_logger->setFilepath(
+			m_log_path + "mvsim_" + m_name + LOGGER_POSE + ext);
+
+	for (size_t i = 0; i < m_wheel_loggers.size(); i++)
+		m_wheel_loggers[i]->setFilepath(
+			m_log_path + "mvsim_" + m_name + LOGGER_WHEEL +
+			std::to_string(i + 1) + ext);
 }
 
 void VehicleBase::writeLogStrings()
@@ -0,0 +1,109 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+#pragma once
+
+#include <mvsim/VehicleBase.h>
+#include <mvsim/World.h>
+
+#include <cmath>
+
+namespace mvsim
+{
+template <size_t NUM_WHEELS, class INVOKE_CONTROLLERS>
+void VehicleBase::internal_simul_pre_timestep(
+	const TSimulContext& context, const INVOKE_CONTROLLERS& invokeControllers)
+{
+	Simulable::simul_pre_timestep(context);
+	for (auto& s : m_sensors) s->simul_pre_timestep(context);
+
+	const size_t nW = NUM_WHEELS != 0 ? NUM_WHEELS : getNumWheels();
+
+	// Update wheels position (they may turn, etc. as in an Ackermann
+	// configuration)
+	for (size_t i = 0; i < nW; i++)
+	{
+		const Wheel& w = m_wheels_info[i];
+		m_wheel_shapes[i]->SetAsBox(
+			w.diameter * 0.5, w.width * 0.5, b2Vec2(w.x, w.y), w.yaw);
+	}
+
+	// Apply motor forces/torques:
+	invokeControllers(context, m_torque_per_wheel);
+
+	// Apply friction model at each wheel:
+	ASSERT_EQUAL_(m_torque_per_wheel.size(), nW);
+
+	const double gravity = getWorldObject()->get_gravity();
+	const double massPerWheel =
+		getChassisMass() / nW;  // Part of the vehicle weight on each wheel.
+	const double weightPerWheel = massPerWheel * gravity;
+
+	// Velocity of each wheel center (local coords), as in
+	// getWheelsVelocityLocal(), without a temporary vector:
+	const mrpt::math::TTwist2D veh_vel = getVelocityLocal();
+	const auto wheelVel = [&](const Wheel& w) {
+		return mrpt::math::TPoint2D(
+			veh_vel.vx - veh_vel.omega * w.y, veh_vel.vy + veh_vel.omega * w.x);
+	};
+
+	if (m_friction_batch)
+	{
+		// Evaluated later on by the World, for all vehicles at once:
+		FrictionBatch& b = *m_friction_batch;
+		ASSERT_LE_(m_friction_batch_first + nW, b.size());
+		for (size_t i = 0; i < nW; i++)
+		{
+			const Wheel& w = m_wheels_info[i];
+			const size_t k = m_friction_batch_first + i;
+			const mrpt::math::TPoint2D vel = wheelVel(w);
+
+			b.vel_x[k] = vel.x;
+			b.vel_y[k] = vel.y;
+			b.cos_yaw[k] = std::cos(w.yaw);
+			b.sin_yaw[k] = std::sin(w.yaw);
+			// "-" => Forwards is negative:
+			b.torque[k] = -m_torque_per_wheel[i];
+			b.weight[k] = weightPerWheel;
+			b.mass[k] = w.mass;
+			b.Iyy[k] = w.Iyy;
+			b.radius[k] = 0.5 * w.diameter;
+			b.w[k] = w.getW();
+			b.dt[k] = context.dt;
+		}
+		return;
+	}
+
+	std::vector<mrpt::math::TSegment3D>
+		force_vectors;  // For visualization only
+
+	for (size_t i = 0; i < nW; i++)
+	{
+		// prepare data:
+		Wheel& w = m_wheels_info[i];
+
+		FrictionBase::TFrictionInput fi(context, w);
+		fi.motor_torque =
+			-m_torque_per_wheel[i];  // "-" => Forwards is negative
+		fi.weight = weightPerWheel;
+		fi.wheel_speed = wheelVel(w);
+
+		CSVLogger& logger = *m_wheel_loggers[i];
+		m_friction->setLogger(logger.isRecording() ? &logger : nullptr);
+
+		// eval friction:
+		mrpt::math::TPoint2D net_force_;
+		m_friction->evaluate_friction(fi, net_force_);
+
+		internal_apply_wheel_friction(fi, i, net_force_, force_vectors);
+	}
+
+	internal_save_force_vectors(force_vectors);
+}
+
+}  // namespace mvsim
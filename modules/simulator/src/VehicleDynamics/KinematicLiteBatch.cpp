@@ -0,0 +1,193 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mvsim/VehicleDynamics/KinematicLiteBatch.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace mvsim;
+
+void KinematicLiteBatch::resize(size_t n)
+{
+	ackermann.assign(n, 0);
+	for (auto* vec :
+		 {&wheelbase, &tan_max_steer, &max_speed, &max_omega, &max_accel,
+		  &safety_distance, &radius, &x, &y, &yaw, &cmd_v, &cmd_w, &v, &w,
+		  &vel_x, &vel_y})
+		vec->assign(n, 0.0);
+}
+
+void KinematicLiteBatch::setParams(size_t i, const KinematicLiteParams& p)
+{
+	ackermann[i] = p.ackermann ? 1 : 0;
+	wheelbase[i] = p.wheelbase;
+	tan_max_steer[i] = std::tan(p.max_steer);
+	max_speed[i] = p.max_speed;
+	max_omega[i] = p.max_omega;
+	max_accel[i] = p.max_accel;
+	safety_distance[i] = p.safety_distance;
+	radius[i] = p.radius;
+}
+
+void KinematicLiteBatch::addObstacle(double ox, double oy, double oradius)
+{
+	m_obs_x.push_back(ox);
+	m_obs_y.push_back(oy);
+	m_obs_r.push_back(oradius);
+}
+
+static inline uint32_t cellBucket(double px, double py, double cellSize,
+	int dx, int dy, uint32_t bucketMask)
+{
+	const auto cx = static_cast<int64_t>(std::floor(px / cellSize)) + dx;
+	const auto cy = static_cast<int64_t>(std::floor(py / cellSize)) + dy;
+	return static_cast<uint32_t>(
+			   static_cast<uint64_t>(cx * 73856093) ^
+			   static_cast<uint64_t>(cy * 19349663)) &
+		   bucketMask;
+}
+
+void KinematicLiteBatch::evaluate(const double dt)
+{
+	const size_t n = size();
+	const size_t nItems = n + m_obs_x.size();
+
+	const auto itemX = [&](size_t k) { return k < n ? x[k] : m_obs_x[k - n]; };
+	const auto itemY = [&](size_t k) { return k < n ? y[k] : m_obs_y[k - n]; };
+
+	// 1) Spatial hash of agents and obstacles. Cells are large enough for all
+	// objects an agent may run into to be in the 3x3 cells around it:
+	double maxRadius = 0, maxSafety = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		maxRadius = std::max(maxRadius, radius[i]);
+		maxSafety = std::max(maxSafety, safety_distance[i]);
+	}
+	for (const double r : m_obs_r) maxRadius = std::max(maxRadius, r);
+	const double cellSize = std::max(1e-3, 2 * maxRadius + maxSafety);
+
+	uint32_t nBuckets = 1;
+	while (nBuckets < nItems) nBuckets <<= 1;
+	const uint32_t bucketMask = nBuckets - 1;
+
+	// Counting sort by bucket:
+	m_item_bucket.resize(nItems);
+	m_bucket_start.assign(nBuckets + 1, 0);
+	for (size_t k = 0; k < nItems; k++)
+	{
+		const uint32_t b =
+			cellBucket(itemX(k), itemY(k), cellSize, 0, 0, bucketMask);
+		m_item_bucket[k] = b;
+		m_bucket_start[b]++;
+	}
+	for (uint32_t b = 1; b < nBuckets; b++)
+		m_bucket_start[b] += m_bucket_start[b - 1];
+	m_bucket_start[nBuckets] = static_cast<uint32_t>(nItems);
+
+	m_bucket_items.resize(nItems);
+	for (size_t k = nItems; k-- > 0;)
+		m_bucket_items[--m_bucket_start[m_item_bucket[k]]] =
+			static_cast<uint32_t>(k);
+
+	// 2) Velocities and new poses:
+	for (size_t i = 0; i < n; i++)
+	{
+		double vd = std::min(std::max(cmd_v[i], -max_speed[i]), max_speed[i]);
+		if (vd != 0)
+		{
+			const double vFree = internal_max_free_speed(
+				i, vd > 0 ? 1.0 : -1.0, cellSize, bucketMask);
+			vd = std::min(std::max(vd, -vFree), vFree);
+		}
+
+		double vi = vd;
+		if (max_accel[i] > 0)
+		{
+			const double dv = max_accel[i] * dt;
+			vi = v[i] + std::min(std::max(vd - v[i], -dv), dv);
+		}
+
+		double wi;
+		if (ackermann[i])
+		{
+			// Steering for the commanded curvature, then the actual w:
+			const double L = wheelbase[i];
+			const double tanSteer =
+				cmd_v[i] != 0 ? std::min(
+									std::max(
+										cmd_w[i] * L / cmd_v[i],
+										-tan_max_steer[i]),
+									tan_max_steer[i])
+							  : 0.0;
+			wi = vi * tanSteer / L;
+		}
+		else
+			wi = std::min(std::max(cmd_w[i], -max_omega[i]), max_omega[i]);
+
+		// Exact integration of constant (v,w) along dt: the chord of the arc
+		// has length v*dt*sinc(w*dt/2), with heading yaw+w*dt/2.
+		const double a = 0.5 * wi * dt;
+		const double sinc = std::abs(a) < 1e-6 ? 1.0 - a * a / 6.0
+											   : std::sin(a) / a;
+		vel_x[i] = vi * sinc * std::cos(yaw[i] + a);
+		vel_y[i] = vi * sinc * std::sin(yaw[i] + a);
+
+		v[i] = vi;
+		w[i] = wi;
+	}
+
+	m_obs_x.clear();
+	m_obs_y.clear();
+	m_obs_r.clear();
+}
+
+double KinematicLiteBatch::internal_max_free_speed(
+	size_t i, double dir, double cellSize, uint32_t bucketMask) const
+{
+	const size_t n = size();
+	const double c = dir * std::cos(yaw[i]), s = dir * std::sin(yaw[i]);
+
+	double minGap = std::numeric_limits<double>::max();
+	for (int dx = -1; dx <= 1; dx++)
+	{
+		for (int dy = -1; dy <= 1; dy++)
+		{
+			const uint32_t b =
+				cellBucket(x[i], y[i], cellSize, dx, dy, bucketMask);
+
+			for (uint32_t idx = m_bucket_start[b];
+				 idx < m_bucket_start[b + 1]; idx++)
+			{
+				const uint32_t k = m_bucket_items[idx];
+				if (k == i) continue;
+
+				const double ox = k < n ? x[k] : m_obs_x[k - n];
+				const double oy = k < n ? y[k] : m_obs_y[k - n];
+				const double orad = k < n ? radius[k] : m_obs_r[k - n];
+
+				// In the frame of the agent, looking along its motion:
+				const double rx = ox - x[i], ry = oy - y[i];
+				const double lon = c * rx + s * ry;
+				if (lon <= 0) continue;
+
+				const double rr = radius[i] + orad;
+				if (std::abs(-s * rx + c * ry) >= rr) continue;
+
+				minGap = std::min(minGap, lon - rr);
+			}
+		}
+	}
+
+	// Full speed until safety_distance, then slowing down to stop:
+	if (minGap >= safety_distance[i]) return max_speed[i];
+	if (minGap <= 0) return 0;
+	return max_speed[i] * minGap / safety_distance[i];
+}
@@ -182,21 +182,27 @@ void DynamicsAckermann::invoke_motor_controllers(
 		ci.context = context;
 		TControllerOutput co;
 		m_controller->control_step(ci, co);
-		// Take its output:
-		out_torque_per_wheel[WHEEL_RL] = co.rl_torque;
-		out_torque_per_wheel[WHEEL_RR] = co.rr_torque;
-		out_torque_per_wheel[WHEEL_FL] = co.fl_torque;
-		out_torque_per_wheel[WHEEL_FR] = co.fr_torque;
-
-		// Kinematically-driven steering wheels:
-		// Ackermann formulas for inner&outer weels turning angles wrt the
-		// equivalent (central) one:
-		computeFrontWheelAngles(
-			co.steer_ang, m_wheels_info[WHEEL_FL].yaw,
-			m_wheels_info[WHEEL_FR].yaw);
+		apply_controller_output(co, out_torque_per_wheel);
 	}
 }
 
+void DynamicsAckermann::apply_controller_output(
+	const TControllerOutput& co, std::vector<double>& out_torque_per_wheel)
+{
+	out_torque_per_wheel.resize(4);
+	out_torque_per_wheel[WHEEL_RL] = co.rl_torque;
+	out_torque_per_wheel[WHEEL_RR] = co.rr_torque;
+	out_torque_per_wheel[WHEEL_FL] = co.fl_torque;
+	out_torque_per_wheel[WHEEL_FR] = co.fr_torque;
+
+	// Kinematically-driven steering wheels:
+	// Ackermann formulas for inner&outer weels turning angles wrt the
+	// equivalent (central) one:
+	computeFrontWheelAngles(
+		co.steer_ang, m_wheels_info[WHEEL_FL].yaw,
+		m_wheels_info[WHEEL_FR].yaw);
+}
+
 void DynamicsAckermann::computeFrontWheelAngles(
 	const double desired_equiv_steer_ang, double& out_fl_ang,
 	double& out_fr_ang) const
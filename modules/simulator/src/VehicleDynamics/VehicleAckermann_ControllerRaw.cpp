@@ -7,6 +7,7 @@
   |   See COPYING                                                           |
   +-------------------------------------------------------------------------+ */
 
+#include <mrpt/serialization/CArchive.h>
 #include <mvsim/VehicleDynamics/VehicleAckermann.h>
 #include "xml_utils.h"
 
@@ -88,3 +89,15 @@ void DynamicsAckermann::ControllerRawForces::teleop_interface(
 		"setpoint: t=%.03f steer=%.03f deg\n", setpoint_wheel_torque_l,
 		setpoint_steer_ang * 180.0 / M_PI);
 }
+
+void DynamicsAckermann::ControllerRawForces::saveState(
+	mrpt::serialization::CArchive& out) const
+{
+	out << setpoint_wheel_torque_l << setpoint_wheel_torque_r << setpoint_steer_ang;
+}
+
+void DynamicsAckermann::ControllerRawForces::restoreState(
+	mrpt::serialization::CArchive& in)
+{
+	in >> setpoint_wheel_torque_l >> setpoint_wheel_torque_r >> setpoint_steer_ang;
+}
@@ -7,6 +7,7 @@
   |   See COPYING                                                           |
   +-------------------------------------------------------------------------+ */
 
+#include <mrpt/serialization/CArchive.h>
 #include <mvsim/VehicleDynamics/VehicleAckermann.h>
 #include "xml_utils.h"
 
@@ -184,3 +185,19 @@ void DynamicsAckermann::ControllerTwistFrontSteerPID::teleop_interface(
 		"setpoint: v=%.03f w=%.03f deg/s\n", setpoint_lin_speed,
 		setpoint_ang_speed * 180.0 / M_PI);
 }
+
+void DynamicsAckermann::ControllerTwistFrontSteerPID::saveState(
+	mrpt::serialization::CArchive& out) const
+{
+	out << setpoint_lin_speed << setpoint_ang_speed;
+	m_PID[0].saveState(out);
+	m_PID[1].saveState(out);
+}
+
+void DynamicsAckermann::ControllerTwistFrontSteerPID::restoreState(
+	mrpt::serialization::CArchive& in)
+{
+	in >> setpoint_lin_speed >> setpoint_ang_speed;
+	m_PID[0].restoreState(in);
+	m_PID[1].restoreState(in);
+}
@@ -7,6 +7,7 @@
   |   See COPYING                                                           |
   +-------------------------------------------------------------------------+ */
 
+#include <mrpt/serialization/CArchive.h>
 #include <mvsim/VehicleDynamics/VehicleAckermann_Drivetrain.h>
 #include "xml_utils.h"
 
@@ -117,3 +118,17 @@ void DynamicsAckermannDrivetrain::ControllerFrontSteerPID::teleop_interface(
 		"setpoint: v=%.03f steer=%.03f deg\n", setpoint_lin_speed,
 		setpoint_steer_ang * 180.0 / M_PI);
 }
+
+void DynamicsAckermannDrivetrain::ControllerFrontSteerPID::saveState(
+	mrpt::serialization::CArchive& out) const
+{
+	out << setpoint_lin_speed << setpoint_steer_ang;
+	m_twist_control.saveState(out);
+}
+
+void DynamicsAckermannDrivetrain::ControllerFrontSteerPID::restoreState(
+	mrpt::serialization::CArchive& in)
+{
+	in >> setpoint_lin_speed >> setpoint_steer_ang;
+	m_twist_control.restoreState(in);
+}
@@ -7,6 +7,7 @@
   |   See COPYING                                                           |
   +-------------------------------------------------------------------------+ */
 
+#include <mrpt/serialization/CArchive.h>
 #include <mvsim/VehicleDynamics/VehicleAckermann_Drivetrain.h>
 
 #include "xml_utils.h"
@@ -82,3 +83,15 @@ void DynamicsAckermannDrivetrain::ControllerRawForces::teleop_interface(
 		"setpoint: t=%.03f steer=%.03f deg\n", setpoint_wheel_torque,
 		setpoint_steer_ang * 180.0 / M_PI);
 }
+
+void DynamicsAckermannDrivetrain::ControllerRawForces::saveState(
+	mrpt::serialization::CArchive& out) const
+{
+	out << setpoint_wheel_torque << setpoint_steer_ang;
+}
+
+void DynamicsAckermannDrivetrain::ControllerRawForces::restoreState(
+	mrpt::serialization::CArchive& in)
+{
+	in >> setpoint_wheel_torque >> setpoint_steer_ang;
+}
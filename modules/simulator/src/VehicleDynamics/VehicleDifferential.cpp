@@ -140,12 +140,18 @@ void DynamicsDifferential::invoke_motor_controllers(
 		ci.context = context;
 		TControllerOutput co;
 		m_controller->control_step(ci, co);
-		// Take its output:
-		out_torque_per_wheel[WHEEL_L] = co.wheel_torque_l;
-		out_torque_per_wheel[WHEEL_R] = co.wheel_torque_r;
+		apply_controller_output(co, out_torque_per_wheel);
 	}
 }
 
+void DynamicsDifferential::apply_controller_output(
+	const TControllerOutput& co, std::vector<double>& out_torque_per_wheel)
+{
+	out_torque_per_wheel.resize(2);
+	out_torque_per_wheel[WHEEL_L] = co.wheel_torque_l;
+	out_torque_per_wheel[WHEEL_R] = co.wheel_torque_r;
+}
+
 // See docs in base class:
 mrpt::math::TTwist2D DynamicsDifferential::getVelocityLocalOdoEstimate() const
 {
@@ -7,6 +7,7 @@
   |   See COPYING                                                           |
   +-------------------------------------------------------------------------+ */
 
+#include <mrpt/serialization/CArchive.h>
 #include <mvsim/VehicleDynamics/VehicleDifferential.h>
 //#include <mvsim/World.h>
 //#include <rapidxml.hpp>
@@ -65,3 +66,15 @@ void DynamicsDifferential::ControllerRawForces::teleop_interface(
 		"setpoint: tl=%.03f tr=%.03f deg\n", setpoint_wheel_torque_l,
 		setpoint_wheel_torque_r);
 }
+
+void DynamicsDifferential::ControllerRawForces::saveState(
+	mrpt::serialization::CArchive& out) const
+{
+	out << setpoint_wheel_torque_l << setpoint_wheel_torque_r;
+}
+
+void DynamicsDifferential::ControllerRawForces::restoreState(
+	mrpt::serialization::CArchive& in)
+{
+	in >> setpoint_wheel_torque_l >> setpoint_wheel_torque_r;
+}
@@ -7,6 +7,7 @@
   |   See COPYING                                                           |
   +-------------------------------------------------------------------------+ */
 
+#include <mrpt/serialization/CArchive.h>
 #include <mvsim/VehicleDynamics/VehicleDifferential.h>
 #include "xml_utils.h"
 
@@ -120,3 +121,19 @@ void DynamicsDifferential::ControllerTwistPID::teleop_interface(
 		"setpoint: lin=%.03f ang=%.03f deg/s\n", setpoint_lin_speed,
 		180.0 / M_PI * setpoint_ang_speed);
 }
+
+void DynamicsDifferential::ControllerTwistPID::saveState(
+	mrpt::serialization::CArchive& out) const
+{
+	out << setpoint_lin_speed << setpoint_ang_speed;
+	m_PID[0].saveState(out);
+	m_PID[1].saveState(out);
+}
+
+void DynamicsDifferential::ControllerTwistPID::restoreState(
+	mrpt::serialization::CArchive& in)
+{
+	in >> setpoint_lin_speed >> setpoint_ang_speed;
+	m_PID[0].restoreState(in);
+	m_PID[1].restoreState(in);
+}
@@ -0,0 +1,238 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mrpt/serialization/CArchive.h>
+#include <mvsim/VehicleDynamics/VehicleKinematicLite.h>
+#include <mvsim/World.h>
+
+#include <rapidxml.hpp>
+
+#include "xml_utils.h"
+
+using namespace mvsim;
+using namespace std;
+
+// Ctor:
+DynamicsKinematicLite::DynamicsKinematicLite(World* parent)
+	: VehicleBase(parent, 0 /*num wheels*/)
+{
+	m_chassis_color = mrpt::img::TColor(0xff, 0x80, 0x00);
+}
+
+/** The derived-class part of load_params_from_xml() */
+void DynamicsKinematicLite::dynamics_load_params_from_xml(
+	const rapidxml::xml_node<char>* xml_node)
+{
+	const std::map<std::string, std::string> varValues = {{"NAME", m_name}};
+
+	// <chassis ...> </chassis>
+	const rapidxml::xml_node<char>* xml_chassis =
+		xml_node->first_node("chassis");
+	if (xml_chassis)
+	{
+		TParameterDefinitions attribs;
+		attribs["zmin"] = TParamEntry("%lf", &this->m_chassis_z_min);
+		attribs["zmax"] = TParamEntry("%lf", &this->m_chassis_z_max);
+		attribs["color"] = TParamEntry("%color", &this->m_chassis_color);
+
+		parse_xmlnode_attribs(
+			*xml_chassis, attribs, varValues,
+			"[DynamicsKinematicLite::dynamics_load_params_from_xml]");
+
+		const rapidxml::xml_node<char>* xml_shape =
+			xml_chassis->first_node("shape");
+		if (xml_shape)
+			mvsim::parse_xmlnode_shape(
+				*xml_shape, m_chassis_poly,
+				"[DynamicsKinematicLite::dynamics_load_params_from_xml]");
+	}
+
+	// Kinematic model:
+	std::string model = "unicycle";
+	TParameterDefinitions params;
+	params["model"] = TParamEntry("%s", &model);
+	params["wheelbase"] = TParamEntry("%lf", &m_params.wheelbase);
+	params["max_steer_ang_deg"] = TParamEntry("%lf_deg", &m_params.max_steer);
+	params["max_speed"] = TParamEntry("%lf", &m_params.max_speed);
+	params["max_omega"] = TParamEntry("%lf_deg", &m_params.max_omega);
+	params["max_accel"] = TParamEntry("%lf", &m_params.max_accel);
+	params["safety_distance"] = TParamEntry("%lf", &m_params.safety_distance);
+
+	parse_xmlnode_children_as_param(
+		*xml_node, params, varValues,
+		"[DynamicsKinematicLite::dynamics_load_params_from_xml]");
+
+	if (model == "ackermann")
+		m_params.ackermann = true;
+	else if (model == "unicycle")
+		m_params.ackermann = false;
+	else
+		THROW_EXCEPTION_FMT(
+			"[DynamicsKinematicLite] Invalid <model>: '%s' (valid: unicycle, "
+			"ackermann)",
+			model.c_str());
+	ASSERT_GT_(m_params.wheelbase, 0);
+
+	// Vehicle controller:
+	if (const rapidxml::xml_node<char>* xml_control =
+			xml_node->first_node("controller");
+		xml_control)
+	{
+		const rapidxml::xml_attribute<char>* control_class =
+			xml_control->first_attribute("class");
+		if (control_class && std::string(control_class->value()) !=
+								 ControllerTwist::class_name())
+			throw runtime_error(mrpt::format(
+				"[DynamicsKinematicLite] Unknown 'class'='%s' in "
+				"<controller> XML node",
+				control_class->value()));
+
+		m_controller.load_config(*xml_control);
+	}
+}
+
+void DynamicsKinematicLite::create_multibody_system(b2World& world)
+{
+	// Moved by setting its velocity, see applyBatchOutputs():
+	b2BodyDef bodyDef;
+	bodyDef.type = b2_kinematicBody;
+
+	m_b2d_body = world.CreateBody(&bodyDef);
+
+	const size_t nPts = m_chassis_poly.size();
+	ASSERT_(nPts >= 3);
+	ASSERT_LE_(nPts, (size_t)b2_maxPolygonVertices);
+	std::vector<b2Vec2> pts(nPts);
+	for (size_t i = 0; i < nPts; i++)
+		pts[i] = b2Vec2(m_chassis_poly[i].x, m_chassis_poly[i].y);
+
+	b2PolygonShape chassisPoly;
+	chassisPoly.Set(&pts[0], nPts);
+
+	b2FixtureDef fixtureDef;
+	fixtureDef.shape = &chassisPoly;
+	fixtureDef.restitution = 0.01;
+	fixtureDef.friction = 0.3f;
+	m_fixture_chassis = m_b2d_body->CreateFixture(&fixtureDef);
+
+	// Kinematic bodies rotate around their origin:
+	m_chassis_com = mrpt::math::TPoint2D(0, 0);
+	m_wheel_shapes.clear();
+
+	m_params.radius = getMaxVehicleRadius();
+}
+
+void DynamicsKinematicLite::simul_post_timestep(const TSimulContext& context)
+{
+	Simulable::simul_post_timestep(context);
+}
+
+void DynamicsKinematicLite::setBatchParams(
+	KinematicLiteBatch& b, size_t i) const
+{
+	b.setParams(i, m_params);
+}
+
+void DynamicsKinematicLite::fillBatchInputs(
+	KinematicLiteBatch& b, size_t i) const
+{
+	const auto q = getPose();
+	b.x[i] = q.x;
+	b.y[i] = q.y;
+	b.yaw[i] = q.yaw;
+	b.cmd_v[i] = m_controller.setpoint_lin_speed;
+	b.cmd_w[i] = m_controller.setpoint_ang_speed;
+	b.v[i] = m_v;
+	b.w[i] = m_w;
+}
+
+void DynamicsKinematicLite::applyBatchOutputs(
+	const KinematicLiteBatch& b, size_t i)
+{
+	m_v = b.v[i];
+	m_w = b.w[i];
+
+	// Cheaper than SetTransform(), which looks for new contacts right away:
+	m_b2d_body->SetLinearVelocity(b2Vec2(b.vel_x[i], b.vel_y[i]));
+	m_b2d_body->SetAngularVelocity(m_w);
+	if (m_v != 0 || m_w != 0) m_b2d_body->SetAwake(true);
+}
+
+void DynamicsKinematicLite::saveState(mrpt::serialization::CArchive& out) const
+{
+	VehicleBase::saveState(out);
+	out << m_v << m_w;
+}
+
+void DynamicsKinematicLite::restoreState(mrpt::serialization::CArchive& in)
+{
+	VehicleBase::restoreState(in);
+	in >> m_v >> m_w;
+}
+
+void DynamicsKinematicLite::ControllerTwist::load_config(
+	const rapidxml::xml_node<char>& node)
+{
+	// Initial speed.
+	TParameterDefinitions params;
+	params["V"] = TParamEntry("%lf", &this->setpoint_lin_speed);
+	params["W"] = TParamEntry("%lf_deg", &this->setpoint_ang_speed);
+
+	parse_xmlnode_children_as_param(node, params);
+}
+
+void DynamicsKinematicLite::ControllerTwist::teleop_interface(
+	const TeleopInput& in, TeleopOutput& out)
+{
+	switch (in.keycode)
+	{
+		case 'W':
+		case 'w':
+			setpoint_lin_speed += 0.1;
+			break;
+
+		case 'S':
+		case 's':
+			setpoint_lin_speed -= 0.1;
+			break;
+
+		case 'A':
+		case 'a':
+			setpoint_ang_speed += 2.0 * M_PI / 180;
+			break;
+
+		case 'D':
+		case 'd':
+			setpoint_ang_speed -= 2.0 * M_PI / 180;
+			break;
+
+		case ' ':
+			setpoint_lin_speed = 0.0;
+			setpoint_ang_speed = 0.0;
+			break;
+	};
+	out.append_gui_lines +=
+		"[Controller=" + string(class_name()) +
+		"] Teleop keys: w/s=forward/backward. a/d=left/right. spacebar=stop.\n";
+	out.append_gui_lines += mrpt::format(
+		"setpoint: lin=%.03f ang=%.03f deg/s\n", setpoint_lin_speed,
+		180.0 / M_PI * setpoint_ang_speed);
+}
+
+void DynamicsKinematicLite::ControllerTwist::saveState(
+	mrpt::serialization::CArchive& out) const
+{
+	out << setpoint_lin_speed << setpoint_ang_speed;
+}
+
+void DynamicsKinematicLite::ControllerTwist::restoreState(
+	mrpt::serialization::CArchive& in)
+{
+	in >> setpoint_lin_speed >> setpoint_ang_speed;
+}
@@ -0,0 +1,74 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mvsim/VehicleDynamics/VehicleSpecialized.h>
+
+#include "VehicleBase_impl.h"
+
+using namespace mvsim;
+
+template <class DYNAMICS, class CONTROLLER, size_t NUM_WHEELS>
+VehicleSpecialized<DYNAMICS, CONTROLLER, NUM_WHEELS>::
+	VehicleSpecialized(World* parent)
+	: DYNAMICS(parent)
+{
+	ASSERT_EQUAL_(this->getNumWheels(), NUM_WHEELS);
+}
+
+template <class DYNAMICS, class CONTROLLER, size_t NUM_WHEELS>
+void VehicleSpecialized<DYNAMICS, CONTROLLER, NUM_WHEELS>::
+	invoke_motor_controllers(
+		const TSimulContext& context, std::vector<double>& out_torque_per_wheel)
+{
+	// The factory only creates this class for this kind of controller:
+	ASSERTDEB_(dynamic_cast<CONTROLLER*>(this->getController().get()));
+	auto& controller = static_cast<CONTROLLER&>(*this->getController());
+
+	typename DYNAMICS::TControllerInput ci;
+	ci.context = context;
+	typename DYNAMICS::TControllerOutput co;
+	controller.CONTROLLER::control_step(ci, co);
+
+	this->apply_controller_output(co, out_torque_per_wheel);
+}
+
+template <class DYNAMICS, class CONTROLLER, size_t NUM_WHEELS>
+void VehicleSpecialized<DYNAMICS, CONTROLLER, NUM_WHEELS>::
+	simul_pre_timestep(const TSimulContext& context)
+{
+	this->template internal_simul_pre_timestep<NUM_WHEELS>(
+		context, [this](const TSimulContext& c, std::vector<double>& torques) {
+			VehicleSpecialized::invoke_motor_controllers(c, torques);
+		});
+}
+
+namespace mvsim
+{
+template class VehicleSpecialized<
+	DynamicsDifferential, DynamicsDifferential::ControllerTwistPID, 2>;
+template class VehicleSpecialized<
+	DynamicsAckermann, DynamicsAckermann::ControllerFrontSteerPID, 4>;
+}  // namespace mvsim
+
+VehicleBase::Ptr mvsim::createSpecializedVehicle(
+	World* parent, const std::string& dynamicsClass,
+	const std::string& controllerClass)
+{
+	if (dynamicsClass == "differential" &&
+		controllerClass ==
+			DynamicsDifferential::ControllerTwistPID::class_name())
+		return std::make_shared<DynamicsDifferentialTwistPID>(parent);
+
+	if (dynamicsClass == "ackermann" &&
+		controllerClass ==
+			DynamicsAckermann::ControllerFrontSteerPID::class_name())
+		return std::make_shared<DynamicsAckermannFrontSteerPID>(parent);
+
+	return {};
+}
@@ -7,6 +7,7 @@
   |   See COPYING                                                           |
   +-------------------------------------------------------------------------+ */
 
+#include <mrpt/serialization/CArchive.h>
 #include <mvsim/VehicleDynamics/VehicleAckermann_Drivetrain.h>
 #include "xml_utils.h"
 
@@ -115,3 +116,17 @@ void DynamicsAckermannDrivetrain::ControllerTwistFrontSteerPID::
 		"setpoint: v=%.03f w=%.03f deg/s\n", setpoint_lin_speed,
 		setpoint_ang_speed * 180.0 / M_PI);
 }
+
+void DynamicsAckermannDrivetrain::ControllerTwistFrontSteerPID::saveState(
+	mrpt::serialization::CArchive& out) const
+{
+	out << setpoint_lin_speed << setpoint_ang_speed;
+	m_PID.saveState(out);
+}
+
+void DynamicsAckermannDrivetrain::ControllerTwistFrontSteerPID::restoreState(
+	mrpt::serialization::CArchive& in)
+{
+	in >> setpoint_lin_speed >> setpoint_ang_speed;
+	m_PID.restoreState(in);
+}
@@ -29,6 +29,13 @@ void VisualObject::guiUpdate(mrpt::opengl::COpenGLScene& scene)
 {
 	using namespace std::string_literals;
 
+	// Despawned and spawned again?
+	if (m_glRemoved)
+	{
+		for (const auto& o : m_glInserted) scene.insert(o);
+		m_glRemoved = false;
+	}
+
 	const auto objectPose = internalGuiGetVisualPose();
 
 	if (m_glCustomVisual)
@@ -42,7 +49,7 @@ void VisualObject::guiUpdate(mrpt::opengl::COpenGLScene& scene)
 			const auto name = "_autoViz"s + std::to_string(m_glCustomVisualId);
 			m_glCustomVisual->setName(name);
 			// Add to the 3D scene:
-			scene.insert(m_glCustomVisual);
+			guiInsert(scene, m_glCustomVisual);
 		}
 
 		// Update pose:
@@ -58,7 +65,7 @@ void VisualObject::guiUpdate(mrpt::opengl::COpenGLScene& scene)
 			glBox->setBoxCorners(viz_bbmin_, viz_bbmax_);
 			m_glBoundingBox->insert(glBox);
 			m_glBoundingBox->setVisibility(false);
-			scene.insert(m_glBoundingBox);
+			guiInsert(scene, m_glBoundingBox);
 		}
 		m_glBoundingBox->setPose(objectPose);
 	}
@@ -68,6 +75,21 @@ void VisualObject::guiUpdate(mrpt::opengl::COpenGLScene& scene)
 	internalGuiUpdate(scene, childrenOnly);
 }
 
+void VisualObject::guiRemove(mrpt::opengl::COpenGLScene& scene)
+{
+	if (m_glRemoved) return;
+	for (const auto& o : m_glInserted) scene.removeObject(o);
+	m_glRemoved = true;
+}
+
+void VisualObject::guiInsert(
+	mrpt::opengl::COpenGLScene& scene,
+	const std::shared_ptr<mrpt::opengl::CRenderizable>& obj)
+{
+	scene.insert(obj);
+	m_glInserted.push_back(obj);
+}
+
 bool VisualObject::parseVisual(const rapidxml::xml_node<char>* visual_node)
 {
 	MRPT_TRY_START
@@ -101,9 +123,8 @@ bool VisualObject::parseVisual(const rapidxml::xml_node<char>* visual_node)
 	ASSERT_FILE_EXISTS_(localFileName);
 
 	auto glGroup = mrpt::opengl::CSetOfObjects::Create();
-	auto glModel = mrpt::opengl::CAssimpModel::Create();
-
-	glModel->loadScene(localFileName);
+	// Shared by all objects with the same model:
+	auto glModel = m_world->loadVisualModel(localFileName);
 
 	mrpt::math::TPoint3D bbmin, bbmax;
 #if MRPT_VERSION >= 0x218
@@ -133,6 +154,21 @@ bool VisualObject::parseVisual(const rapidxml::xml_node<char>* visual_node)
 	MRPT_TRY_END
 }
 
+void VisualObject::shareVisual(const VisualObject& o)
+{
+	m_glBoundingBox = mrpt::opengl::CSetOfObjects::Create();
+	viz_bbmin_ = o.viz_bbmin_;
+	viz_bbmax_ = o.viz_bbmax_;
+
+	if (!o.m_glCustomVisual) return;
+
+	// A new root, with its own pose, for the same (shared) model group:
+	m_glCustomVisual = mrpt::opengl::CSetOfObjects::Create();
+	for (const auto& glObj : *o.m_glCustomVisual)
+		m_glCustomVisual->insert(glObj);
+	m_glBoundingBox->setVisibility(o.m_glBoundingBox->isVisible());
+}
+
 void VisualObject::showBoundingBox(bool show)
 {
 	if (!m_glBoundingBox) return;
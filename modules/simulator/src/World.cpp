@@ -7,18 +7,30 @@
   |   See COPYING                                                           |
   +-------------------------------------------------------------------------+ */
 #include <mrpt/core/lock_helper.h>
+#include <mrpt/opengl/CAssimpModel.h>
 #include <mrpt/system/filesystem.h>	 // filePathSeparatorsToNative()
+#include <mvsim/VehicleDynamics/VehicleKinematicLite.h>
 #include <mvsim/World.h>
 
 #include <algorithm>  // count()
+#include <future>
 #include <map>
 #include <stdexcept>
+#include <thread>
 
 #include "GenericAnswer.pb.h"
+#include "SrvDespawn.pb.h"
 #include "SrvGetPose.pb.h"
 #include "SrvGetPoseAnswer.pb.h"
+#include "SrvProfiler.pb.h"
+#include "SrvProfilerAnswer.pb.h"
 #include "SrvSetPose.pb.h"
 #include "SrvSetPoseAnswer.pb.h"
+#include "SrvSimControlAnswer.pb.h"
+#include "SrvSimPause.pb.h"
+#include "SrvSimRun.pb.h"
+#include "SrvSimStep.pb.h"
+#include "SrvSpawn.pb.h"
 
 using namespace mvsim;
 using namespace std;
@@ -32,6 +44,9 @@ World::World() : mrpt::system::COutputLogger("mvsim::World")
 // Dtor.
 World::~World()
 {
+	stopRealtime();
+	stopInputRecording();
+
 	if (m_gui_thread.joinable())
 	{
 		MRPT_LOG_DEBUG("Waiting for GUI thread to quit...");
@@ -49,8 +64,12 @@ void World::clear_all()
 {
 	auto lck = mrpt::lockHelper(m_world_cs);
 
+	// Sensors may still be running in the background:
+	m_task_scheduler.wait_pipelined();
+
 	// Reset params:
 	m_simul_time = 0.0;
+	m_timestep_count = 0;
 
 	// (B2D) World contents:
 	// ---------------------------------------------
@@ -65,6 +84,34 @@ void World::clear_all()
 	m_vehicles.clear();
 	m_world_elements.clear();
 	m_blocks.clear();
+	m_block_prototypes.clear();
+	m_simulableObjects.clear();
+	m_spawn_pools.clear();
+	m_spawn_classes.clear();
+
+	m_object_table.clear();
+	m_object_names.clear();
+	m_free_handles.clear();
+	m_hot_state = ObjectsHotState();
+	m_object_names_changed = true;
+	std::atomic_store(
+		&m_hot_state_published, std::shared_ptr<const ObjectsHotState>());
+	m_hot_state_spare.reset();
+
+	m_task_scheduler_outdated = true;
+
+	m_friction_batch_vehicles.clear();
+	m_friction_batch_handles.clear();
+	m_friction_batch_first_wheel.clear();
+	m_friction_batch_outdated = true;
+
+	m_kinematic_lite_vehicles.clear();
+	m_kinematic_lite_handles.clear();
+	m_kinematic_lite_outdated = true;
+
+	m_lod_vehicles.clear();
+	m_lod_steps.clear();
+	m_lod_outdated = true;
 }
 
 /** Runs the simulation for a given time interval (in seconds) */
@@ -82,7 +129,7 @@ void World::run_simulation(double dt)
 	const double end_time = m_simul_time + dt;
 	// tolerance for rounding errors summing time steps
 	const double timetol = 1e-6;
-	while (m_simul_time < (end_time - timetol))
+	while (!m_paused && m_simul_time < (end_time - timetol))
 	{
 		// Timestep: always "simul_step" for the sake of repeatibility
 		internal_one_timestep(m_simul_timestep);
@@ -100,18 +147,137 @@ void World::internal_one_timestep(double dt)
 
 	m_timer_iteration.Tic();
 
+	// Changes requested from other threads:
+	internal_process_command_queue();
+
 	TSimulContext context;
 	context.world = this;
 	context.b2_world = m_box2d_world.get();
 	context.simul_time = m_simul_time;
 	context.dt = dt;
 
+	if (m_task_scheduler_outdated ||
+		m_task_scheduler.getTimestep() != dt)
+		internal_rebuild_task_scheduler(dt);
+
+	if (m_friction_batch_outdated) internal_rebuild_friction_batch();
+	if (m_kinematic_lite_outdated) internal_rebuild_kinematic_lite();
+	if (m_lod_outdated) internal_rebuild_lod();
+
+	// Per-object profiling (no-op if disabled):
+	using Phase = SimulableProfiler::Phase;
+	const bool profiling = m_profiler.isEnabled();
+	if (profiling)
+		m_profiler.prepare(m_object_table.size(), m_task_scheduler.size());
+
+	const auto preStep = [&](ObjectHandle h) {
+		const uint32_t steps = m_lod_steps[h];	// See TLODOptions
+		if (!steps) return;
+		m_profiler.measure(Phase::PreStep, h, [&]() {
+			if (steps == 1)
+			{
+				m_object_table[h]->simul_pre_timestep(context);
+				return;
+			}
+			// Its forces are held for several timesteps:
+			TSimulContext lodContext = context;
+			lodContext.dt *= steps;
+			m_object_table[h]->simul_pre_timestep(lodContext);
+		});
+	};
+	const auto postStep = [&](ObjectHandle h) {
+		m_profiler.measure(Phase::PostStep, h, [&]() {
+			m_object_table[h]->simul_post_timestep(context);
+		});
+	};
+
 	// 1) Pre-step
 	{
 		mrpt::system::CTimeLoggerEntry tle(m_timlogger, "timestep.0.prestep");
 
-		for (auto& e : m_simulableObjects)
-			if (e.second) e.second->simul_pre_timestep(context);
+		// Box2D writes go first, sequentially (they modify the broad-phase):
+		for (ObjectHandle h = 0; h < m_object_table.size(); h++)
+		{
+			Simulable* s = m_object_table[h];
+			// Moved externally: idle objects would not refresh it otherwise
+			if (s && s->simul_sync_b2d_body()) internal_update_hot_state(h);
+		}
+
+		internal_update_lod();
+		internal_update_active_simulables();
+
+		// Objects that may touch other objects (e.g. world elements):
+		for (const auto h : m_active_objects)
+			if (!m_object_table[h]->simul_is_parallel_safe()) preStep(h);
+
+		internal_run_parallel_simulables(preStep);
+
+		// Wheel friction, for all vehicles at once:
+		if (m_friction_batch.size())
+		{
+			mrpt::system::CTimeLoggerEntry tle2(
+				m_timlogger, "timestep.0.prestep.friction");
+
+			// Only vehicles simulated in this timestep (see TLODOptions),
+			// with consecutive ones evaluated as a single range of wheels:
+			const size_t nVeh = m_friction_batch_vehicles.size();
+			for (size_t i = 0; i < nVeh;)
+			{
+				if (!m_lod_steps[m_friction_batch_handles[i]])
+				{
+					i++;
+					continue;
+				}
+				size_t j = i + 1;
+				while (j < nVeh && m_lod_steps[m_friction_batch_handles[j]])
+					j++;
+
+				m_friction_batch.evaluate(
+					m_gravity, m_friction_batch_first_wheel[i],
+					m_friction_batch_first_wheel[j]);
+				for (; i < j; i++)
+					m_friction_batch_vehicles[i]->apply_batched_friction(
+						context);
+			}
+		}
+
+		// Kinematic-only vehicles, all at once:
+		if (m_kinematic_lite.size())
+		{
+			mrpt::system::CTimeLoggerEntry tle2(
+				m_timlogger, "timestep.0.prestep.kinematic_lite");
+
+			const size_t n = m_kinematic_lite_vehicles.size();
+			for (size_t i = 0; i < n; i++)
+				m_kinematic_lite_vehicles[i]->fillBatchInputs(
+					m_kinematic_lite, i);
+
+			// The other vehicles are avoided, too:
+			for (const auto& v : m_vehicles)
+			{
+				if (v.second->simul_is_batched()) continue;
+				const auto q = v.second->getPose();
+				m_kinematic_lite.addObstacle(
+					q.x, q.y, v.second->getMaxVehicleRadius());
+			}
+
+			m_kinematic_lite.evaluate(dt);
+
+			for (size_t i = 0; i < n; i++)
+				m_kinematic_lite_vehicles[i]->applyBatchOutputs(
+					m_kinematic_lite, i);
+		}
+
+		// Apply queued forces in a fixed order, for repeatibility no matter
+		// the number of threads:
+		for (const auto h : m_active_objects)
+		{
+			const uint32_t steps = m_lod_steps[h];
+			if (!steps)
+				m_object_table[h]->simul_pre_timestep_recommit();
+			else
+				m_object_table[h]->simul_pre_timestep_commit(steps > 1);
+		}
 	}
 
 	// 2) Run dynamics
@@ -121,6 +287,7 @@ void World::internal_one_timestep(double dt)
 
 		m_box2d_world->Step(dt, m_b2d_vel_iters, m_b2d_pos_iters);
 		m_simul_time += dt;	 // Avance time
+		m_timestep_count++;
 	}
 
 	// 3) Save dynamical state and post-step processing:
@@ -128,15 +295,342 @@ void World::internal_one_timestep(double dt)
 		mrpt::system::CTimeLoggerEntry tle(
 			m_timlogger, "timestep.3.save_dynstate");
 
-		for (auto& e : m_simulableObjects)
-			if (e.second) e.second->simul_post_timestep(context);
+		// Bodies may have been woken up by contacts:
+		internal_update_active_simulables();
+
+		internal_run_parallel_simulables(postStep);
+
+		for (const auto h : m_active_objects)
+		{
+			Simulable* s = m_object_table[h];
+			if (!s->simul_is_parallel_safe()) postStep(h);
+			s->simul_post_timestep_commit(context);
+			internal_update_hot_state(h);
+		}
+
+		// Batched objects are never active (see Simulable::simul_is_idle()):
+		for (size_t i = 0; i < m_kinematic_lite_vehicles.size(); i++)
+		{
+			m_kinematic_lite_vehicles[i]->simul_post_timestep(context);
+			internal_update_hot_state(m_kinematic_lite_handles[i]);
+		}
 	}
 
+	// 4) Periodic tasks due now (sensors, publishing, etc.). Sensors only
+	// read the world, so they all run in parallel first:
+	{
+		mrpt::system::CTimeLoggerEntry tle(
+			m_timlogger, "timestep.4.periodic_tasks");
+
+		m_task_scheduler.run_due_tasks(
+			context, profiling ? &m_profiler : nullptr,
+			[this](size_t n, const std::function<void(size_t)>& f) {
+				internal_parallel_for(n, f);
+			});
+	}
+
+	m_hot_state.simul_time = m_simul_time;
+	internal_publish_hot_state();
+
 	const double ts = m_timer_iteration.Tac();
 	m_timlogger.registerUserMeasure("timestep", ts);
 	if (ts > dt) m_timlogger.registerUserMeasure("timestep_too_slow_alert", ts);
 }
 
+void World::internal_update_active_simulables()
+{
+	m_active_objects.clear();
+	m_parallel_objects.clear();
+
+	for (ObjectHandle h = 0; h < m_object_table.size(); h++)
+	{
+		Simulable* s = m_object_table[h];
+		if (!s || s->simul_is_idle()) continue;
+
+		m_active_objects.push_back(h);
+		if (s->simul_is_parallel_safe()) m_parallel_objects.push_back(h);
+	}
+}
+
+void World::internal_update_hot_state(ObjectHandle h)
+{
+	const Simulable& s = *m_object_table[h];
+
+	m_hot_state.pose[h] = s.getPose();
+	m_hot_state.twist[h] = s.getTwist();
+	m_hot_state.in_collision[h] = s.isInCollision() ? 1 : 0;
+	m_hot_state.had_collision[h] = s.hadCollision() ? 1 : 0;
+}
+
+void World::internal_publish_hot_state()
+{
+	if (m_object_names_changed)
+	{
+		m_hot_state.names =
+			std::make_shared<const std::unordered_map<std::string, ObjectHandle>>(
+				m_object_names);
+		m_object_names_changed = false;
+	}
+
+	// Reuse the memory of the former state, if no reader holds it:
+	std::shared_ptr<ObjectsHotState> st;
+	if (m_hot_state_spare && m_hot_state_spare.use_count() == 1)
+		st = std::move(m_hot_state_spare);
+	else
+		st = std::make_shared<ObjectsHotState>();
+
+	*st = m_hot_state;
+
+	auto old = std::atomic_exchange(
+		&m_hot_state_published, std::shared_ptr<const ObjectsHotState>(st));
+	m_hot_state_spare = std::const_pointer_cast<ObjectsHotState>(old);
+}
+
+void World::internal_process_command_queue()
+{
+	std::function<void()> cmd;
+	while (m_command_queue.pop(cmd)) cmd();
+}
+
+World::ObjectHandle World::getObjectHandle(const std::string& name) const
+{
+	const auto it = m_object_names.find(name);
+	return it == m_object_names.end() ? INVALID_OBJECT_HANDLE : it->second;
+}
+
+World::ObjectHandle World::internal_insert_simulable(
+	const Simulable::Ptr& s, ObjectHandle h)
+{
+	ASSERT_(s);
+
+	if (h == INVALID_OBJECT_HANDLE)
+		h = m_free_handles.empty()
+				? static_cast<ObjectHandle>(m_object_table.size())
+				: *m_free_handles.begin();
+	ASSERT_LT_(h, INVALID_OBJECT_HANDLE);
+
+	if (h >= m_object_table.size())
+	{
+		// Handles skipped over are free:
+		for (auto i = m_object_table.size(); i < h; i++)
+			m_free_handles.insert(static_cast<ObjectHandle>(i));
+
+		m_object_table.resize(h + 1);
+		m_hot_state.pose.resize(h + 1);
+		m_hot_state.twist.resize(h + 1);
+		m_hot_state.in_collision.resize(h + 1);
+		m_hot_state.had_collision.resize(h + 1);
+	}
+	else
+	{
+		const bool wasFree = m_free_handles.erase(h) == 1;
+		ASSERTMSG_(wasFree, "Object handle already in use");
+		m_profiler.clearObject(h);
+	}
+
+	m_simulableObjects.insert(
+		m_simulableObjects.end(), std::make_pair(s->getName(), s));
+
+	m_object_table[h] = s.get();
+	// Duplicated names: keep the first one, as std::multimap::find() did
+	m_object_names.emplace(s->getName(), h);
+
+	internal_update_hot_state(h);
+	m_object_names_changed = true;
+
+	m_task_scheduler_outdated = true;
+	m_friction_batch_outdated = true;
+	m_kinematic_lite_outdated = true;
+	m_lod_outdated = true;
+
+	return h;
+}
+
+// Smallest index not returned by getIndex() for any object in lst:
+template <class LIST, class GET_INDEX>
+static size_t unusedIndex(const LIST& lst, const GET_INDEX& getIndex)
+{
+	std::vector<bool> used(lst.size(), false);
+	for (const auto& o : lst)
+		if (const size_t idx = getIndex(*o.second); idx < used.size())
+			used[idx] = true;
+
+	return std::find(used.begin(), used.end(), false) - used.begin();
+}
+
+size_t World::internal_unused_vehicle_index() const
+{
+	return unusedIndex(
+		m_vehicles, [](const VehicleBase& v) { return v.getVehicleIndex(); });
+}
+
+size_t World::internal_unused_block_index() const
+{
+	return unusedIndex(
+		m_blocks, [](const Block& b) { return b.getBlockIndex(); });
+}
+
+void World::internal_rebuild_friction_batch()
+{
+	// Vehicles with rolling resistance go first, see FrictionBatch:
+	struct Entry
+	{
+		ObjectHandle h;
+		VehicleBase* veh;
+		FrictionBatchParams p;
+	};
+	std::vector<Entry> withRR, noRR;
+	for (ObjectHandle h = 0; h < m_object_table.size(); h++)
+	{
+		auto* veh = dynamic_cast<VehicleBase*>(m_object_table[h]);
+		if (!veh) continue;
+
+		FrictionBatchParams p;
+		if (!veh->simul_is_batched() && veh->getFrictionBatchParams(p))
+			(p.hasRollingResistance() ? withRR : noRR).push_back({h, veh, p});
+		else
+			veh->setFrictionBatch(nullptr);
+	}
+
+	size_t nWheels = 0;
+	for (const auto* lst : {&withRR, &noRR})
+		for (const auto& e : *lst) nWheels += e.veh->getNumWheels();
+
+	m_friction_batch.resize(nWheels);
+	m_friction_batch_vehicles.clear();
+	m_friction_batch_handles.clear();
+	m_friction_batch_first_wheel.clear();
+
+	size_t k = 0;
+	for (const auto* lst : {&withRR, &noRR})
+	{
+		for (const auto& e : *lst)
+		{
+			e.veh->setFrictionBatch(&m_friction_batch, k);
+			m_friction_batch_vehicles.push_back(e.veh);
+			m_friction_batch_handles.push_back(e.h);
+			m_friction_batch_first_wheel.push_back(k);
+
+			for (size_t i = 0; i < e.veh->getNumWheels(); i++)
+				m_friction_batch.setParams(k++, e.p);
+		}
+		if (lst == &withRR) m_friction_batch.numRollingResistance = k;
+	}
+	m_friction_batch_first_wheel.push_back(k);
+
+	m_friction_batch_outdated = false;
+
+	MRPT_LOG_DEBUG_FMT(
+		"Friction batch rebuilt with %zu vehicles, %zu wheels",
+		m_friction_batch_vehicles.size(), nWheels);
+}
+
+void World::internal_rebuild_kinematic_lite()
+{
+	m_kinematic_lite_vehicles.clear();
+	m_kinematic_lite_handles.clear();
+
+	for (ObjectHandle h = 0; h < m_object_table.size(); h++)
+	{
+		auto* v = dynamic_cast<DynamicsKinematicLite*>(m_object_table[h]);
+		if (!v) continue;
+
+		m_kinematic_lite_vehicles.push_back(v);
+		m_kinematic_lite_handles.push_back(h);
+	}
+
+	m_kinematic_lite.resize(m_kinematic_lite_vehicles.size());
+	for (size_t i = 0; i < m_kinematic_lite_vehicles.size(); i++)
+		m_kinematic_lite_vehicles[i]->setBatchParams(m_kinematic_lite, i);
+
+	m_kinematic_lite_outdated = false;
+
+	MRPT_LOG_DEBUG_FMT(
+		"Kinematic-only vehicles batch rebuilt with %zu vehicles",
+		m_kinematic_lite_vehicles.size());
+}
+
+void World::internal_rebuild_task_scheduler(double dt)
+{
+	const size_t oldTaskCount = m_task_scheduler.size();
+
+	m_task_scheduler.clear(dt, m_simul_time);
+
+	if (m_sensors_pipelined)
+	{
+		if (!m_sensor_threads_pool)
+		{
+			const size_t nThreads =
+				m_simul_threads > 0 ? static_cast<size_t>(m_simul_threads)
+									: std::thread::hardware_concurrency();
+			m_sensor_threads_pool = std::make_unique<mrpt::WorkerThreadsPool>(
+				std::max<size_t>(1, nThreads));
+		}
+
+		m_task_scheduler.setPipelined([this](const std::function<void()>& f) {
+			return m_sensor_threads_pool->enqueue(f);
+		});
+	}
+	else
+		m_task_scheduler.setPipelined(TaskScheduler::enqueue_t());
+
+	for (auto& e : m_simulableObjects)
+		if (e.second) e.second->registerPeriodicTasks(m_task_scheduler);
+
+	// Task indices are only kept if the same tasks were registered again:
+	if (m_task_scheduler.size() != oldTaskCount)
+		m_profiler.clear(SimulableProfiler::Phase::PeriodicTask);
+
+	m_task_scheduler_outdated = false;
+
+	MRPT_LOG_DEBUG_FMT(
+		"Periodic task scheduler rebuilt with %zu tasks",
+		m_task_scheduler.size());
+}
+
+void World::internal_run_parallel_simulables(
+	const std::function<void(ObjectHandle)>& f)
+{
+	internal_parallel_for(m_parallel_objects.size(), [&](size_t k) {
+		f(m_parallel_objects[k]);
+	});
+}
+
+void World::internal_parallel_for(
+	size_t n, const std::function<void(size_t)>& f)
+{
+	size_t nThreads = m_simul_threads > 0
+						  ? static_cast<size_t>(m_simul_threads)
+						  : std::thread::hardware_concurrency();
+	nThreads = std::max<size_t>(1, std::min(nThreads, n));
+
+	if (nThreads == 1)
+	{
+		for (size_t k = 0; k < n; k++) f(k);
+		return;
+	}
+
+	if (!m_simul_threads_pool || m_simul_threads_pool->size() < nThreads)
+		m_simul_threads_pool =
+			std::make_unique<mrpt::WorkerThreadsPool>(nThreads);
+
+	// Split into contiguous chunks, one per thread:
+	std::vector<std::future<void>> tasks;
+	tasks.reserve(nThreads);
+	for (size_t i = 0; i < nThreads; i++)
+	{
+		const size_t idx0 = (n * i) / nThreads;
+		const size_t idx1 = (n * (i + 1)) / nThreads;
+		tasks.emplace_back(m_simul_threads_pool->enqueue([&f, idx0, idx1]() {
+			for (size_t k = idx0; k < idx1; k++) f(k);
+		}));
+	}
+
+	// Wait for all, and rethrow any exception:
+	for (auto& t : tasks) t.wait();
+	for (auto& t : tasks) t.get();
+}
+
 std::string World::xmlPathToActualPath(const std::string& modelURI) const
 {
 	std::string localFileName;
@@ -157,6 +651,21 @@ std::string World::xmlPathToActualPath(const std::string& modelURI) const
 	return resolvePath(localFileName);
 }
 
+std::shared_ptr<mrpt::opengl::CAssimpModel> World::loadVisualModel(
+	const std::string& localFileName)
+{
+	std::lock_guard<std::mutex> lck(m_visual_models_mtx);
+
+	if (auto it = m_visual_models.find(localFileName);
+		it != m_visual_models.end())
+		return it->second;
+
+	auto m = mrpt::opengl::CAssimpModel::Create();
+	m->loadScene(localFileName);
+	m_visual_models[localFileName] = m;
+	return m;
+}
+
 /** Replace macros, prefix the base_path if input filename is relative, etc.
  */
 std::string World::resolvePath(const std::string& s_in) const
@@ -188,6 +697,12 @@ std::string World::resolvePath(const std::string& s_in) const
 	return mrpt::system::filePathSeparatorsToNative(ret);
 }
 
+void World::runWithSimulationLocked(const std::function<void()>& f)
+{
+	std::lock_guard<std::mutex> lck(m_simulationStepRunningMtx);
+	f();
+}
+
 /** Run the user-provided visitor on each vehicle */
 void World::runVisitorOnVehicles(const vehicle_visitor_t& v)
 {
@@ -202,6 +717,65 @@ void World::runVisitorOnWorldElements(const world_element_visitor_t& v)
 		if (we) v(*we);
 }
 
+// Handle of the object requested in a get/set_pose service call, or
+// INVALID_OBJECT_HANDLE:
+template <class REQUEST>
+static World::ObjectHandle requestedObjectHandle(
+	const World::ObjectsHotState& st, const REQUEST& req)
+{
+	World::ObjectHandle h = World::INVALID_OBJECT_HANDLE;
+	if (req.has_objecthandle())
+		h = req.objecthandle();
+	else if (st.names)
+	{
+		const auto it = st.names->find(req.objectid());
+		if (it != st.names->end()) h = it->second;
+	}
+	return h < st.pose.size() ? h : World::INVALID_OBJECT_HANDLE;
+}
+
+// Answer to the "sim/*" services, optionally with the state of all objects:
+static mvsim_msgs::SrvSimControlAnswer simControlAnswer(
+	const World& world, bool withState)
+{
+	mvsim_msgs::SrvSimControlAnswer ans;
+	ans.set_success(true);
+	ans.set_paused(world.isPaused());
+
+	const auto st = world.getPublishedObjectsState();
+	ans.set_simultime(st ? st->simul_time : world.get_simul_time());
+	if (!st || !withState) return ans;
+
+	auto* objs = ans.mutable_objects();
+	objs->Reserve(st->pose.size());
+	for (World::ObjectHandle h = 0; h < st->pose.size(); h++)
+	{
+		auto* o = objs->Add();
+		o->set_objecthandle(h);
+
+		const mrpt::math::TPose3D& p = st->pose[h];
+		auto* po = o->mutable_pose();
+		po->set_x(p.x);
+		po->set_y(p.y);
+		po->set_z(p.z);
+		po->set_yaw(p.yaw);
+		po->set_pitch(p.pitch);
+		po->set_roll(p.roll);
+
+		const mrpt::math::TTwist2D& t = st->twist[h];
+		auto* tw = o->mutable_twist();
+		tw->set_vx(t.vx);
+		tw->set_vy(t.vy);
+		tw->set_vz(0);
+		tw->set_wx(0);
+		tw->set_wy(0);
+		tw->set_wz(t.omega);
+
+		o->set_isincollision(st->in_collision[h] != 0);
+	}
+	return ans;
+}
+
 void World::connectToServer()
 {
 	//
@@ -216,58 +790,61 @@ void World::connectToServer()
 		o.second->registerOnServer(m_client);
 	}
 
-	// global services:
+	// global services. They do not block waiting for the simulation step:
+	// poses are read from the last published state, and changes are
+	// enqueued to be done before the next timestep.
 	m_client
 		.advertiseService<mvsim_msgs::SrvSetPose, mvsim_msgs::SrvSetPoseAnswer>(
 			"set_pose",
 			std::function<mvsim_msgs::SrvSetPoseAnswer(
 				const mvsim_msgs::SrvSetPose&)>(
 				[this](const mvsim_msgs::SrvSetPose& req) {
-					std::lock_guard<std::mutex> lck(m_simulationStepRunningMtx);
-
 					mvsim_msgs::SrvSetPoseAnswer ans;
 					ans.set_objectisincollision(false);
 
-					const auto sId = req.objectid();
+					const auto st = getPublishedObjectsState();
+					const ObjectHandle h =
+						st ? requestedObjectHandle(*st, req)
+						   : INVALID_OBJECT_HANDLE;
 
-					if (auto itV = m_simulableObjects.find(sId);
-						itV != m_simulableObjects.end())
+					if (h == INVALID_OBJECT_HANDLE)
 					{
-						if (req.has_relativeincrement() &&
-							req.relativeincrement())
-						{
-							auto p =
-								mrpt::poses::CPose3D(itV->second->getPose());
-							p = p + mrpt::poses::CPose3D(
-										req.pose().x(), req.pose().y(),
-										req.pose().z(), req.pose().yaw(),
-										req.pose().pitch(), req.pose().roll());
-							itV->second->setPose(p.asTPose());
-
-							auto* absPose = ans.mutable_objectglobalpose();
-							absPose->set_x(p.x());
-							absPose->set_y(p.y());
-							absPose->set_z(p.z());
-							absPose->set_yaw(p.yaw());
-							absPose->set_pitch(p.pitch());
-							absPose->set_roll(p.roll());
-						}
-						else
-						{
-							itV->second->setPose(
-								{req.pose().x(), req.pose().y(), req.pose().z(),
-								 req.pose().yaw(), req.pose().pitch(),
-								 req.pose().roll()});
-						}
-						ans.set_success(true);
-						ans.set_objectisincollision(
-							itV->second->hadCollision());
-						itV->second->resetCollisionFlag();
+						ans.set_success(false);
+						return ans;
 					}
-					else
+
+					const mrpt::math::TPose3D reqPose = {
+						req.pose().x(),		req.pose().y(),
+						req.pose().z(),		req.pose().yaw(),
+						req.pose().pitch(), req.pose().roll()};
+					const bool relative =
+						req.has_relativeincrement() && req.relativeincrement();
+
+					if (relative)
 					{
-						ans.set_success(false);
+						// Predicted pose, unless other commands for this
+						// object are still pending:
+						const auto p = mrpt::poses::CPose3D(st->pose[h]) +
+									   mrpt::poses::CPose3D(reqPose);
+
+						auto* absPose = ans.mutable_objectglobalpose();
+						absPose->set_x(p.x());
+						absPose->set_y(p.y());
+						absPose->set_z(p.z());
+						absPose->set_yaw(p.yaw());
+						absPose->set_pitch(p.pitch());
+						absPose->set_roll(p.roll());
 					}
+
+					TExternalInput in;
+					in.kind = relative ? TExternalInput::Kind::SetPoseRelative
+									   : TExternalInput::Kind::SetPose;
+					in.object = h;
+					in.pose = reqPose;
+					enqueueInput(in);
+
+					ans.set_success(true);
+					ans.set_objectisincollision(st->had_collision[h] != 0);
 					return ans;
 				}));
 
@@ -277,46 +854,188 @@ void World::connectToServer()
 			std::function<mvsim_msgs::SrvGetPoseAnswer(
 				const mvsim_msgs::SrvGetPose&)>(
 				[this](const mvsim_msgs::SrvGetPose& req) {
-					std::lock_guard<std::mutex> lck(m_simulationStepRunningMtx);
-
 					mvsim_msgs::SrvGetPoseAnswer ans;
-					const auto sId = req.objectid();
 					ans.set_objectisincollision(false);
 
-					if (auto itV = m_simulableObjects.find(sId);
-						itV != m_simulableObjects.end())
+					const auto st = getPublishedObjectsState();
+					const ObjectHandle h =
+						st ? requestedObjectHandle(*st, req)
+						   : INVALID_OBJECT_HANDLE;
+
+					if (h == INVALID_OBJECT_HANDLE)
 					{
-						ans.set_success(true);
-						const mrpt::math::TPose3D p = itV->second->getPose();
-						auto* po = ans.mutable_pose();
-						po->set_x(p.x);
-						po->set_y(p.y);
-						po->set_z(p.z);
-						po->set_yaw(p.yaw);
-						po->set_pitch(p.pitch);
-						po->set_roll(p.roll);
-
-						ans.set_objectisincollision(
-							itV->second->hadCollision());
-						itV->second->resetCollisionFlag();
+						ans.set_success(false);
+						return ans;
 					}
+
+					ans.set_success(true);
+					ans.set_objecthandle(h);
+
+					const mrpt::math::TPose3D& p = st->pose[h];
+					auto* po = ans.mutable_pose();
+					po->set_x(p.x);
+					po->set_y(p.y);
+					po->set_z(p.z);
+					po->set_yaw(p.yaw);
+					po->set_pitch(p.pitch);
+					po->set_roll(p.roll);
+
+					ans.set_objectisincollision(st->had_collision[h] != 0);
+
+					TExternalInput in;
+					in.kind = TExternalInput::Kind::ResetCollisionFlag;
+					in.object = h;
+					enqueueInput(in);
+
+					return ans;
+				}));
+
+	m_client
+		.advertiseService<mvsim_msgs::SrvSpawn, mvsim_msgs::GenericAnswer>(
+			"spawn",
+			std::function<mvsim_msgs::GenericAnswer(
+				const mvsim_msgs::SrvSpawn&)>(
+				[this](const mvsim_msgs::SrvSpawn& req) {
+					mvsim_msgs::GenericAnswer ans;
+					ans.set_success(false);
+
+					// Checked again before the next timestep, see
+					// internal_check_spawn():
+					const auto st = getPublishedObjectsState();
+					if (!VehicleBase::is_registered_class(req.classname()) &&
+						!Block::is_registered_class(req.classname()))
+						ans.set_errormessage("Unknown class");
+					else if (
+						st && st->names && st->names->count(req.objectid()))
+						ans.set_errormessage("Object name already in use");
 					else
 					{
+						TExternalInput in;
+						in.kind = TExternalInput::Kind::Spawn;
+						in.className = req.classname();
+						in.name = req.objectid();
+						in.pose = {
+							req.pose().x(),		req.pose().y(),
+							req.pose().z(),		req.pose().yaw(),
+							req.pose().pitch(), req.pose().roll()};
+						enqueueInput(in);
+						ans.set_success(true);
+					}
+					return ans;
+				}));
+
+	m_client
+		.advertiseService<mvsim_msgs::SrvDespawn, mvsim_msgs::GenericAnswer>(
+			"despawn",
+			std::function<mvsim_msgs::GenericAnswer(
+				const mvsim_msgs::SrvDespawn&)>(
+				[this](const mvsim_msgs::SrvDespawn& req) {
+					mvsim_msgs::GenericAnswer ans;
+
+					const auto st = getPublishedObjectsState();
+					const ObjectHandle h =
+						st ? requestedObjectHandle(*st, req)
+						   : INVALID_OBJECT_HANDLE;
+
+					ans.set_success(h != INVALID_OBJECT_HANDLE);
+					if (h == INVALID_OBJECT_HANDLE)
+					{
+						ans.set_errormessage("Unknown object");
+						return ans;
+					}
+
+					TExternalInput in;
+					in.kind = TExternalInput::Kind::Despawn;
+					in.object = h;
+					enqueueInput(in);
+					return ans;
+				}));
+
+	m_client
+		.advertiseService<
+			mvsim_msgs::SrvProfiler, mvsim_msgs::SrvProfilerAnswer>(
+			"profiler",
+			std::function<mvsim_msgs::SrvProfilerAnswer(
+				const mvsim_msgs::SrvProfiler&)>(
+				[this](const mvsim_msgs::SrvProfiler& req) {
+					if (req.has_enable()) enableProfiler(req.enable());
+
+					mvsim_msgs::SrvProfilerAnswer ans;
+					ans.set_success(true);
+					ans.set_enabled(isProfilerEnabled());
+
+					for (const auto& e : getProfilerTopN(req.topn()))
+					{
+						auto* o = ans.add_entries();
+						o->set_objectname(e.name);
+						o->set_phase(SimulableProfiler::phaseName(e.phase));
+						o->set_count(e.stats.count);
+						o->set_totaltime(e.stats.total);
+						o->set_maxtime(e.stats.max);
+					}
+
+					if (req.has_reset() && req.reset()) clearProfiler();
+
+					return ans;
+				}));
+
+	// External (lock-step) control. These run in the services thread, so
+	// "sim/step" replies right after its last timestep. Other services wait
+	// meanwhile, so it runs at most m_sim_step_max_steps per call:
+	m_client
+		.advertiseService<
+			mvsim_msgs::SrvSimPause, mvsim_msgs::SrvSimControlAnswer>(
+			"sim/pause",
+			std::function<mvsim_msgs::SrvSimControlAnswer(
+				const mvsim_msgs::SrvSimPause&)>(
+				[this](const mvsim_msgs::SrvSimPause&) {
+					pauseSimulation();
+					return simControlAnswer(*this, false);
+				}));
+
+	m_client
+		.advertiseService<
+			mvsim_msgs::SrvSimRun, mvsim_msgs::SrvSimControlAnswer>(
+			"sim/run",
+			std::function<mvsim_msgs::SrvSimControlAnswer(
+				const mvsim_msgs::SrvSimRun&)>(
+				[this](const mvsim_msgs::SrvSimRun& req) {
+					if (req.has_rtf() && req.rtf() < 0)
+					{
+						auto ans = simControlAnswer(*this, false);
 						ans.set_success(false);
+						ans.set_errormessage(
+							"rtf must be >=0 (0: resume at the previous rate)");
+						return ans;
 					}
+					resumeSimulation(req.rtf());
+					return simControlAnswer(*this, false);
+				}));
+
+	m_client
+		.advertiseService<
+			mvsim_msgs::SrvSimStep, mvsim_msgs::SrvSimControlAnswer>(
+			"sim/step",
+			std::function<mvsim_msgs::SrvSimControlAnswer(
+				const mvsim_msgs::SrvSimStep&)>(
+				[this](const mvsim_msgs::SrvSimStep& req) {
+					const uint32_t n = std::min<uint32_t>(
+						req.numsteps(), m_sim_step_max_steps);
+					stepSimulation(n);
+					auto ans = simControlAnswer(*this, req.returnstate());
+					ans.set_numstepsdone(n);
 					return ans;
 				}));
+
+	m_connected_to_server = true;
 }
 
-void World::insertBlock(const Block::Ptr& block)
+void World::insertBlock(const Block::Ptr& block, ObjectHandle h)
 {
 	// Assign each block an "index" number
-	block->setBlockIndex(m_blocks.size());
+	block->setBlockIndex(internal_unused_block_index());
 
 	// make sure the name is not duplicated:
 	m_blocks.insert(BlockList::value_type(block->getName(), block));
-	m_simulableObjects.insert(
-		m_simulableObjects.end(),
-		std::make_pair(
-			block->getName(), std::dynamic_pointer_cast<Simulable>(block)));
+	internal_insert_simulable(block, h);
 }
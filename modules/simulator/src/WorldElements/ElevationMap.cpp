@@ -174,7 +174,6 @@ void ElevationMap::simul_pre_timestep(const TSimulContext& context)
 			// This object is faster for repeated point projections
 			const mrpt::poses::CPose3D cur_cpose(cur_pose);
 
-			mrpt::math::TPose3D new_pose = cur_pose;
 			corrs.clear();
 
 			bool out_of_area = false;
@@ -217,14 +216,11 @@ void ElevationMap::simul_pre_timestep(const TSimulContext& context)
 				corrs, tmpl, transf_scale, true /*force scale unity*/);
 
 			m_optimal_transf = mrpt::poses::CPose3D(tmpl);
-			new_pose.z = m_optimal_transf.z();
-			new_pose.yaw = m_optimal_transf.yaw();
-			new_pose.pitch = m_optimal_transf.pitch();
-			new_pose.roll = m_optimal_transf.roll();
 
-			// cout << new_pose << endl;
-
-			itVeh->second->setPose(new_pose);
+			// x, y and yaw are kept as simulated by Box2D:
+			itVeh->second->setPoseOutOfPlane(
+				m_optimal_transf.z(), m_optimal_transf.pitch(),
+				m_optimal_transf.roll());
 
 		}  // end iters
 
@@ -18,12 +18,55 @@
 
 #include <rapidxml.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "xml_utils.h"
 
 using namespace rapidxml;
 using namespace mvsim;
 using namespace std;
 
+namespace
+{
+/** 1D squared distance transform of the sampled function f (Felzenszwalb &
+ * Huttenlocher, "Distance Transforms of Sampled Functions", 2012). v, z are
+ * scratch buffers of n and n+1 elements. */
+void distanceTransform1D(
+	const double* f, const int n, double* d, int* v, double* z)
+{
+	const double inf = std::numeric_limits<double>::infinity();
+	const auto parabolasIntersection = [f](int p, int q) {
+		return ((f[q] + double(q) * q) - (f[p] + double(p) * p)) /
+			   (2.0 * (q - p));
+	};
+
+	// Lower envelope of the parabolas rooted at each sample:
+	int k = 0;
+	v[0] = 0;
+	z[0] = -inf;
+	z[1] = +inf;
+	for (int q = 1; q < n; q++)
+	{
+		double s = parabolasIntersection(v[k], q);
+		while (s <= z[k]) s = parabolasIntersection(v[--k], q);
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = +inf;
+	}
+
+	k = 0;
+	for (int q = 0; q < n; q++)
+	{
+		while (z[k + 1] < q) k++;
+		const double dq = q - v[k];
+		d[q] = dq * dq + f[v[k]];
+	}
+}
+}  // namespace
+
 OccupancyGridMap::OccupancyGridMap(
 	World* parent, const rapidxml::xml_node<char>* root)
 	: WorldElementBase(parent),
@@ -87,6 +130,80 @@ void OccupancyGridMap::loadConfigFrom(const rapidxml::xml_node<char>* root)
 
 		parse_xmlnode_children_as_param(*root, ps);
 	}
+
+	updateDistanceField();
+}
+
+void OccupancyGridMap::updateDistanceField()
+{
+	const int W = m_grid.getSizeX(), H = m_grid.getSizeY();
+	m_dist_field.assign(size_t(W) * H, .0f);
+	if (!W || !H) return;
+
+	// Squared distances, in cells. Non-free cells are the roots; others
+	// start farther away than any cell in the grid:
+	const double farAway = double(W + H) * (W + H);
+	std::vector<double> sqDist(size_t(W) * H);
+	for (int cy = 0; cy < H; cy++)
+		for (int cx = 0; cx < W; cx++)
+			sqDist[cx + cy * W] = m_grid.getCell(cx, cy) <= 0.5f ? .0 : farAway;
+
+	const int n = std::max(W, H);
+	std::vector<double> f(n), d(n), z(n + 1);
+	std::vector<int> v(n);
+
+	// Exact 2D transform, separable into columns, then rows:
+	for (int cx = 0; cx < W; cx++)
+	{
+		for (int cy = 0; cy < H; cy++) f[cy] = sqDist[cx + cy * W];
+		distanceTransform1D(f.data(), H, d.data(), v.data(), z.data());
+		for (int cy = 0; cy < H; cy++) sqDist[cx + cy * W] = d[cy];
+	}
+	for (int cy = 0; cy < H; cy++)
+	{
+		distanceTransform1D(
+			&sqDist[cy * W], W, d.data(), v.data(), z.data());
+		for (int cx = 0; cx < W; cx++)
+			m_dist_field[cx + cy * W] = static_cast<float>(std::sqrt(d[cx]));
+	}
+}
+
+bool OccupancyGridMap::castRay(
+	double x, double y, double angle, double maxRange, float& outRange) const
+{
+	const int W = m_grid.getSizeX(), H = m_grid.getSizeY();
+	ASSERT_EQUAL_(m_dist_field.size(), size_t(W) * H);
+
+	// The ray, in cell units from the grid corner:
+	const double res = m_grid.getResolution();
+	const double x0 = (x - m_grid.getXMin()) / res;
+	const double y0 = (y - m_grid.getYMin()) / res;
+	const double dx = std::cos(angle), dy = std::sin(angle);
+	const double tMax = maxRange / res;
+
+	// Points in a cell at distance d from the closest non-free cell are at
+	// least d-sqrt(2) away from it, so that much can be skipped at once.
+	// Closer to obstacles, march in half cells:
+	const double minStep = 0.5;
+
+	for (double t = 0; t <= tMax;)
+	{
+		const double cxf = std::floor(x0 + t * dx);
+		const double cyf = std::floor(y0 + t * dy);
+		if (cxf < 0 || cyf < 0 || cxf >= W || cyf >= H) return false;
+
+		const int cx = static_cast<int>(cxf), cy = static_cast<int>(cyf);
+		const double d = m_dist_field[cx + cy * W];
+		if (d == 0)
+		{
+			// Unknown cells stop rays without a hit:
+			if (m_grid.getCell(cx, cy) >= 0.5f) return false;
+			outRange = static_cast<float>(t * res);
+			return true;
+		}
+		t += std::max(d - M_SQRT2, minStep);
+	}
+	return false;
 }
 
 void OccupancyGridMap::internalGuiUpdate(
@@ -0,0 +1,111 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mrpt/system/CTicTac.h>
+#include <mvsim/WorldPool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <thread>
+
+using namespace mvsim;
+
+static unsigned int actualThreadCount(unsigned int numThreads)
+{
+	if (numThreads > 0) return numThreads;
+	return std::max(1U, std::thread::hardware_concurrency());
+}
+
+WorldPool::WorldPool(unsigned int numThreads)
+	: mrpt::system::COutputLogger("mvsim::WorldPool"),
+	  m_numThreads(actualThreadCount(numThreads)),
+	  m_threads(m_numThreads)
+{
+}
+
+WorldPool::~WorldPool() { clear(); }
+
+void WorldPool::load_from_XML(
+	size_t numWorlds, const std::string& xml_text,
+	const std::string& fileNameForPath)
+{
+	MRPT_START
+
+	// Sequentially, since XML class registries are global:
+	for (size_t i = 0; i < numWorlds; i++)
+	{
+		auto w = std::make_shared<World>();
+		w->setMinLoggingLevel(this->getMinLoggingLevel());
+		w->load_from_XML(xml_text, fileNameForPath);
+		add(w);
+	}
+
+	MRPT_END
+}
+
+void WorldPool::add(const std::shared_ptr<World>& world)
+{
+	ASSERT_(world);
+	m_worlds.push_back(world);
+}
+
+void WorldPool::clear()
+{
+	m_worlds.clear();
+	resetStats();
+}
+
+void WorldPool::run_simulation(double dt)
+{
+	MRPT_START
+
+	ASSERT_(dt > 0);
+
+	mrpt::system::CTicTac tictac;
+
+	std::vector<double> t0(m_worlds.size());
+	std::vector<std::future<void>> tasks;
+	tasks.reserve(m_worlds.size());
+
+	// One task per world, so faster worlds leave threads free for the rest:
+	for (size_t i = 0; i < m_worlds.size(); i++)
+	{
+		t0[i] = m_worlds[i]->get_simul_time();
+		tasks.emplace_back(m_threads.enqueue(
+			[dt](World* w) { w->run_simulation(dt); }, m_worlds[i].get()));
+	}
+
+	// Barrier, then rethrow any exception:
+	for (auto& t : tasks) t.wait();
+	for (auto& t : tasks) t.get();
+
+	m_total_wall_time += tictac.Tac();
+
+	for (size_t i = 0; i < m_worlds.size(); i++)
+	{
+		const World& w = *m_worlds[i];
+		m_total_timesteps += static_cast<size_t>(std::round(
+			(w.get_simul_time() - t0[i]) / w.get_simul_timestep()));
+	}
+
+	MRPT_END
+}
+
+double WorldPool::getStepsPerSecond() const
+{
+	if (m_total_wall_time <= 0) return 0;
+	return m_total_timesteps / m_total_wall_time;
+}
+
+void WorldPool::resetStats()
+{
+	m_total_timesteps = 0;
+	m_total_wall_time = 0;
+}
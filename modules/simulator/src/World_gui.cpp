@@ -242,7 +242,7 @@ void World::GUI::prepare_editor_window()
 			if (!gui_selectedObject.simulable) return;
 			auto p = gui_selectedObject.simulable->getPose();
 			p.yaw = v;
-			gui_selectedObject.simulable->setPose(p);
+			enqueueSetPose(*gui_selectedObject.simulable, p);
 		});
 		slAngle->setFixedWidth(150);
 		btns_selectedOps.push_back(slAngle);
@@ -291,7 +291,8 @@ void World::GUI::prepare_editor_window()
 
 		formPose->add<nanogui::Button>("Accept")->setCallback(
 			[formPose, this, lbs]() {
-				gui_selectedObject.simulable->setPose(
+				enqueueSetPose(
+					*gui_selectedObject.simulable,
 					{// X:
 					 std::stod(lbs[0]->value()),
 					 // Y:
@@ -444,6 +445,23 @@ void World::internal_GUI_thread()
 	m_gui_thread_running = false;
 }
 
+void World::GUI::enqueueSetPose(
+	const Simulable& s, const mrpt::math::TPose3D& p)
+{
+	// As the "set_pose" service does, so it is recorded by
+	// startInputRecording() and replayed by replayInputLog():
+	const auto st = m_parent.getPublishedObjectsState();
+	if (!st || !st->names) return;
+	const auto it = st->names->find(s.getName());
+	if (it == st->names->end()) return;
+
+	TExternalInput in;
+	in.kind = TExternalInput::Kind::SetPose;
+	in.object = it->second;
+	in.pose = p;
+	m_parent.enqueueInput(in);
+}
+
 void World::GUI::handle_mouse_operations()
 {
 	MRPT_START
@@ -498,7 +516,7 @@ void World::GUI::handle_mouse_operations()
 			p.x = clickedPt.x;
 			p.y = clickedPt.y;
 
-			gui_selectedObject.simulable->setPose(p);
+			enqueueSetPose(*gui_selectedObject.simulable, p);
 		}
 		if (isReplacing && leftClick)
 		{
@@ -514,11 +532,36 @@ void World::GUI::handle_mouse_operations()
 void World::internalUpdate3DSceneObjects(
 	mrpt::opengl::COpenGLScene::Ptr& gl_scene)
 {
+	// Optional per-object profiling:
+	const auto guiUpdate = [&](auto& obj) {
+		const auto h = m_profiler.isEnabled() ? getObjectHandle(obj.getName())
+											  : INVALID_OBJECT_HANDLE;
+		if (h == INVALID_OBJECT_HANDLE)
+		{
+			obj.guiUpdate(*gl_scene);
+			return;
+		}
+		m_profiler.measure(SimulableProfiler::Phase::GuiUpdate, h, [&]() {
+			obj.guiUpdate(*gl_scene);
+		});
+	};
+
+	// Objects may be spawned or despawned meanwhile:
+	auto lck = mrpt::lockHelper(m_world_cs);
+
+	// Remove despawned objects
+	// -----------------------------
+	{
+		std::lock_guard<std::mutex> lck2(m_gui_despawned_mtx);
+		for (auto& o : m_gui_despawned) o->guiRemove(*gl_scene);
+		m_gui_despawned.clear();
+	}
+
 	// Update view of map elements
 	// -----------------------------
 	m_timlogger.enter("update_GUI.2.map-elements");
 
-	for (auto& e : m_world_elements) e->guiUpdate(*gl_scene);
+	for (auto& e : m_world_elements) guiUpdate(*e);
 
 	m_timlogger.leave("update_GUI.2.map-elements");
 
@@ -526,7 +569,7 @@ void World::internalUpdate3DSceneObjects(
 	// -----------------------------
 	m_timlogger.enter("update_GUI.3.vehicles");
 
-	for (auto& v : m_vehicles) v.second->guiUpdate(*gl_scene);
+	for (auto& v : m_vehicles) guiUpdate(*v.second);
 
 	m_timlogger.leave("update_GUI.3.vehicles");
 
@@ -534,7 +577,7 @@ void World::internalUpdate3DSceneObjects(
 	// -----------------------------
 	m_timlogger.enter("update_GUI.4.blocks");
 
-	for (auto& v : m_blocks) v.second->guiUpdate(*gl_scene);
+	for (auto& v : m_blocks) guiUpdate(*v.second);
 
 	m_timlogger.leave("update_GUI.4.blocks");
 
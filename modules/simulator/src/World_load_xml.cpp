@@ -90,24 +90,18 @@ void World::load_from_XML(
 		{
 			WorldElementBase::Ptr e = WorldElementBase::factory(this, node);
 			m_world_elements.emplace_back(e);
-			m_simulableObjects.insert(
-				m_simulableObjects.end(),
-				std::make_pair(
-					e->getName(), std::dynamic_pointer_cast<Simulable>(e)));
+			internal_insert_simulable(e);
 		}
 		// <vehicle> entries:
 		else if (!strcmp(node->name(), "vehicle"))
 		{
 			VehicleBase::Ptr veh = VehicleBase::factory(this, node);
 			// Assign each vehicle a unique "index" number
-			veh->setVehicleIndex(m_vehicles.size());
+			veh->setVehicleIndex(internal_unused_vehicle_index());
 
 			MRPT_TODO("Check for duplicated names")
 			m_vehicles.insert(VehicleList::value_type(veh->getName(), veh));
-			m_simulableObjects.insert(
-				m_simulableObjects.end(),
-				std::make_pair(
-					veh->getName(), std::dynamic_pointer_cast<Simulable>(veh)));
+			internal_insert_simulable(veh);
 		}
 		// <vehicle:class> entries:
 		else if (!strcmp(node->name(), "vehicle:class"))
@@ -130,6 +124,11 @@ void World::load_from_XML(
 		{
 			m_gui_options.parse_from(*node);
 		}
+		// <lod> </lod> params:
+		else if (!strcmp(node->name(), "lod"))
+		{
+			m_lod_options.parse_from(*node);
+		}
 		// <walls> </walls> params:
 		else if (!strcmp(node->name(), "walls"))
 		{
@@ -151,4 +150,7 @@ void World::load_from_XML(
 		// Move on to next node:
 		node = node->next_sibling(nullptr);
 	}
+
+	// Initial state, for readers of getPublishedObjectsState():
+	internal_publish_hot_state();
 }
@@ -0,0 +1,107 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mrpt/system/string_utils.h>
+#include <mvsim/World.h>
+
+#include <cmath>
+#include <limits>
+
+#include "xml_utils.h"
+
+using namespace mvsim;
+
+void World::TLODOptions::parse_from(const rapidxml::xml_node<char>& node)
+{
+	parse_xmlnode_children_as_param(node, params, {}, "[World::TLODOptions]");
+
+	mrpt::system::tokenize(focus, " \t\r\n,", focus_names);
+
+	ASSERT_GE_(far_distance, mid_distance);
+	ASSERT_(mid_decimation >= 1 && far_decimation >= 1);
+}
+
+void World::internal_rebuild_lod()
+{
+	m_lod_vehicles.clear();
+	m_lod_steps.assign(m_object_table.size(), 1);
+
+	for (ObjectHandle h = 0; h < m_object_table.size(); h++)
+	{
+		auto* veh = dynamic_cast<VehicleBase*>(m_object_table[h]);
+		// Batched vehicles are cheap enough already:
+		if (!veh || veh->simul_is_batched()) continue;
+
+		m_lod_vehicles.emplace_back(h, veh);
+	}
+
+	m_lod_outdated = false;
+}
+
+void World::internal_update_lod()
+{
+	const TLODOptions& o = m_lod_options;
+	if (!o.enabled()) return;
+
+	m_lod_focus_points.clear();
+	const auto addFocus = [this](const std::string& name) {
+		if (auto it = m_vehicles.find(name); it != m_vehicles.end())
+		{
+			const auto q = it->second->getPose();
+			m_lod_focus_points.emplace_back(q.x, q.y);
+		}
+	};
+	for (const auto& name : o.focus_names) addFocus(name);
+	if (!m_gui_options.follow_vehicle.empty())
+		addFocus(m_gui_options.follow_vehicle);
+
+	for (const auto& [h, veh] : m_lod_vehicles)
+	{
+		// Still holding the forces of its last run:
+		if (m_timestep_count < veh->getLODNextStep())
+		{
+			m_lod_steps[h] = 0;
+			continue;
+		}
+
+		// No focus vehicle (yet): full detail for all
+		double d = m_lod_focus_points.empty()
+					   ? 0
+					   : std::numeric_limits<double>::max();
+		const auto q = veh->getPose();
+		for (const auto& f : m_lod_focus_points)
+			d = std::min(d, std::hypot(q.x - f.x, q.y - f.y));
+
+		// Hysteresis, so vehicles do not switch levels back and forth:
+		const unsigned int oldLevel = veh->getLODLevel();
+		const double hMid = oldLevel >= 1 ? o.hysteresis : 0;
+		const double hFar = oldLevel >= 2 ? o.hysteresis : 0;
+
+		unsigned int level = 0, decimation = 1;
+		if (d > o.far_distance - hFar)
+		{
+			level = 2;
+			decimation = o.far_decimation;
+		}
+		else if (d > o.mid_distance - hMid)
+		{
+			level = 1;
+			decimation = o.mid_decimation;
+		}
+		veh->setLODLevel(level);
+
+		// Run now, for all timesteps until the next one with
+		// (step + h) % decimation == 0, so vehicles at the same level run in
+		// different timesteps:
+		const uint32_t steps =
+			decimation - (m_timestep_count + h) % decimation;
+		veh->setLODNextStep(m_timestep_count + steps);
+		m_lod_steps[h] = steps;
+	}
+}
@@ -0,0 +1,57 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mvsim/World.h>
+
+#include <sstream>
+
+using namespace mvsim;
+
+void World::clearProfiler()
+{
+	std::lock_guard<std::mutex> lck(m_simulationStepRunningMtx);
+	m_profiler.clear();
+}
+
+std::vector<SimulableProfiler::Entry> World::getProfilerTopN(size_t n)
+{
+	std::lock_guard<std::mutex> lck(m_simulationStepRunningMtx);
+
+	return m_profiler.getTopN(
+		n, [this](SimulableProfiler::Phase phase, size_t idx) -> std::string {
+			if (phase == SimulableProfiler::Phase::PeriodicTask)
+			{
+				if (idx >= m_task_scheduler.size()) return {};
+				const auto& name = m_task_scheduler.getTaskName(idx);
+				return name.empty() ? mrpt::format("task #%zu", idx) : name;
+			}
+
+			const Simulable* s = getObjectByHandle(idx);
+			return s ? s->getName() : std::string();
+		});
+}
+
+std::string World::getProfilerReport(size_t n)
+{
+	const auto entries = getProfilerTopN(n);
+
+	std::stringstream ss;
+	ss << mrpt::format(
+		"%-32s %-14s %10s %12s %12s %12s\n", "Object", "Phase", "Count",
+		"Total [ms]", "Mean [us]", "Max [us]");
+
+	for (const auto& e : entries)
+		ss << mrpt::format(
+			"%-32s %-14s %10lu %12.3f %12.3f %12.3f\n", e.name.c_str(),
+			SimulableProfiler::phaseName(e.phase),
+			static_cast<unsigned long>(e.stats.count), 1e3 * e.stats.total,
+			1e6 * e.stats.mean(), 1e6 * e.stats.max);
+
+	return ss.str();
+}
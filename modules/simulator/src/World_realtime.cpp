@@ -0,0 +1,231 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mvsim/World.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace mvsim;
+
+void World::runRealtime(double rtf, const TRealtimeOptions& options)
+{
+	std::lock_guard<std::mutex> lck(m_realtime_mtx);
+	internal_run_realtime(rtf, options);
+}
+
+bool World::runRealtimeIfStopped(double rtf, const TRealtimeOptions& options)
+{
+	std::lock_guard<std::mutex> lck(m_realtime_mtx);
+	if (m_realtime_running || m_paused) return false;
+
+	internal_run_realtime(rtf, options);
+	return true;
+}
+
+void World::stopRealtime()
+{
+	std::lock_guard<std::mutex> lck(m_realtime_mtx);
+	internal_stop_realtime();
+}
+
+void World::internal_run_realtime(double rtf, const TRealtimeOptions& options)
+{
+	MRPT_START
+
+	ASSERTMSG_(rtf > 0, "Real-time factor must be >0");
+	ASSERT_(options.max_burst_steps > 0);
+
+	// Also joins a thread which already stopped by itself (end_time):
+	internal_stop_realtime();
+
+	m_paused = false;
+	m_realtime_factor = rtf;
+	m_realtime_options = options;
+	{
+		std::lock_guard<std::mutex> lck(m_realtime_stats_mtx);
+		m_realtime_stats = TRealtimeStats();
+	}
+
+	m_realtime_must_stop = false;
+	m_realtime_running = true;
+	m_realtime_thread =
+		std::thread(&World::internal_realtime_thread, this, options);
+
+	MRPT_END
+}
+
+void World::internal_stop_realtime()
+{
+	m_realtime_must_stop = true;
+	if (m_realtime_thread.joinable()) m_realtime_thread.join();
+	m_realtime_running = false;
+}
+
+void World::setRealtimeFactor(double rtf)
+{
+	ASSERTMSG_(rtf > 0, "Real-time factor must be >0");
+	m_realtime_factor = rtf;
+}
+
+World::TRealtimeStats World::getRealtimeStats() const
+{
+	std::lock_guard<std::mutex> lck(m_realtime_stats_mtx);
+	return m_realtime_stats;
+}
+
+void World::internal_realtime_thread(TRealtimeOptions options)
+{
+	using clock = std::chrono::steady_clock;
+	using seconds = std::chrono::duration<double>;
+
+	try
+	{
+		const double dt = m_simul_timestep;
+
+		double rtf = 0;
+		clock::duration period{};
+		// Wall-clock time at which the simulation time was t_anchor. Drift is
+		// measured from here, so it grows with the time lost by Skip and
+		// SlowDown policies:
+		clock::time_point wall_anchor;
+		double t_anchor = 0;
+		clock::time_point deadline;
+
+		// Running jitter stats (Welford's algorithm):
+		uint64_t nWakeUps = 0;
+		double jitterMean = 0, jitterM2 = 0;
+
+		while (!m_realtime_must_stop)
+		{
+			// (Re)start the schedule upon start up or changes of RTF:
+			if (rtf != m_realtime_factor)
+			{
+				rtf = m_realtime_factor;
+				period = std::chrono::duration_cast<clock::duration>(
+					seconds(dt / rtf));
+				wall_anchor = clock::now();
+				t_anchor = m_simul_time;
+				deadline = wall_anchor + period;
+			}
+
+			std::this_thread::sleep_until(deadline);
+			const auto now = clock::now();
+
+			const double late = std::max(0.0, seconds(now - deadline).count());
+
+			size_t nSteps = 1;
+			uint64_t nSkipped = 0;
+			const auto missed =
+				static_cast<uint64_t>(std::floor(late / seconds(period).count()));
+
+			switch (options.catch_up)
+			{
+				case CatchUpPolicy::Burst:
+				{
+					// If more steps are missed, we will be still late in the
+					// next iteration, which will then run without sleeping:
+					nSteps += std::min<uint64_t>(
+						missed, options.max_burst_steps - 1);
+					deadline += nSteps * period;
+				}
+				break;
+				case CatchUpPolicy::Skip:
+					nSkipped = missed;
+					deadline += (1 + missed) * period;
+					break;
+				case CatchUpPolicy::SlowDown:
+					if (missed) deadline = now;
+					deadline += period;
+					break;
+			};
+
+			size_t nRun = 0;
+			for (; nRun < nSteps && !m_realtime_must_stop; nRun++)
+			{
+				if (options.end_time > 0 &&
+					m_simul_time >= options.end_time - 1e-3 * dt)
+				{
+					m_realtime_must_stop = true;
+					break;
+				}
+				internal_one_timestep(dt);
+			}
+
+			// Stats:
+			nWakeUps++;
+			const double delta = late - jitterMean;
+			jitterMean += delta / nWakeUps;
+			jitterM2 += delta * (late - jitterMean);
+
+			const double idealWallTime = (m_simul_time - t_anchor) / rtf;
+			const double drift =
+				seconds(clock::now() - wall_anchor).count() - idealWallTime;
+
+			std::lock_guard<std::mutex> lck(m_realtime_stats_mtx);
+			auto& st = m_realtime_stats;
+			st.timesteps += nRun;
+			if (missed) st.overruns++;
+			st.skipped += nSkipped;
+			st.drift = drift;
+			st.drift_max = std::max(st.drift_max, std::abs(drift));
+			st.jitter_mean = jitterMean;
+			st.jitter_std = nWakeUps > 1 ? std::sqrt(jitterM2 / (nWakeUps - 1))
+										 : .0;
+			st.jitter_max = std::max(st.jitter_max, late);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		MRPT_LOG_ERROR_STREAM(
+			"[World::runRealtime] Exception: " << mrpt::exception_to_str(e));
+	}
+
+	m_realtime_running = false;
+}
+
+void World::pauseSimulation()
+{
+	std::lock_guard<std::mutex> lck(m_realtime_mtx);
+	if (m_paused) return;
+
+	m_realtime_was_running = m_realtime_running;
+	m_paused = true;
+	internal_stop_realtime();
+}
+
+void World::resumeSimulation(double rtf)
+{
+	std::lock_guard<std::mutex> lck(m_realtime_mtx);
+
+	if (rtf > 0)
+		internal_run_realtime(rtf, m_realtime_options);
+	else if (m_paused && m_realtime_was_running)
+		internal_run_realtime(m_realtime_factor, m_realtime_options);
+
+	m_realtime_was_running = false;
+	m_paused = false;
+}
+
+void World::stepSimulation(size_t numSteps)
+{
+	MRPT_START
+
+	ASSERT_(m_simul_timestep > 0);
+
+	pauseSimulation();
+
+	// Each timestep takes m_simulationStepRunningMtx, so services or the GUI
+	// may interleave with these steps, but not other timesteps:
+	for (size_t i = 0; i < numSteps; i++)
+		internal_one_timestep(m_simul_timestep);
+
+	MRPT_END
+}
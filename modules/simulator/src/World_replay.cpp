@@ -0,0 +1,323 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mrpt/io/CFileGZInputStream.h>
+#include <mrpt/io/CFileGZOutputStream.h>
+#include <mrpt/poses/CPose3D.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/crc.h>
+#include <mvsim/World.h>
+
+#include <utility>
+
+using namespace mvsim;
+
+// Log layout: header (magic, version, timestep, initial state), then one
+// record per input, and a final End record with the checksum of the final
+// state. Increment upon any change in the binary format:
+static const uint8_t INPUT_LOG_FORMAT_VERSION = 1;
+static const char* INPUT_LOG_MAGIC = "MVSIM_INPUT_LOG";
+
+enum class LogRecord : uint8_t
+{
+	Input = 0,
+	End
+};
+
+static void writeInput(
+	mrpt::serialization::CArchive& out, uint64_t step,
+	const World::TExternalInput& in)
+{
+	using Kind = World::TExternalInput::Kind;
+
+	out << static_cast<uint8_t>(LogRecord::Input) << step
+		<< static_cast<uint8_t>(in.kind) << in.object;
+
+	switch (in.kind)
+	{
+		case Kind::SetPose:
+		case Kind::SetPoseRelative:
+			out << in.pose.x << in.pose.y << in.pose.z << in.pose.yaw
+				<< in.pose.pitch << in.pose.roll;
+			break;
+		case Kind::TwistCommand:
+			out << in.vx << in.wz;
+			break;
+		case Kind::TeleopKey:
+			out << static_cast<int32_t>(in.keycode);
+			break;
+		case Kind::Spawn:
+			out << in.className << in.name << in.pose.x << in.pose.y
+				<< in.pose.z << in.pose.yaw << in.pose.pitch << in.pose.roll;
+			break;
+		case Kind::ResetCollisionFlag:
+		case Kind::Despawn:
+			break;
+	};
+}
+
+static World::TExternalInput readInput(mrpt::serialization::CArchive& in)
+{
+	using Kind = World::TExternalInput::Kind;
+
+	World::TExternalInput r;
+	uint8_t kind;
+	in >> kind >> r.object;
+	r.kind = static_cast<Kind>(kind);
+
+	switch (r.kind)
+	{
+		case Kind::SetPose:
+		case Kind::SetPoseRelative:
+			in >> r.pose.x >> r.pose.y >> r.pose.z >> r.pose.yaw >>
+				r.pose.pitch >> r.pose.roll;
+			break;
+		case Kind::TwistCommand:
+			in >> r.vx >> r.wz;
+			break;
+		case Kind::TeleopKey:
+		{
+			int32_t k;
+			in >> k;
+			r.keycode = k;
+		}
+		break;
+		case Kind::Spawn:
+			in >> r.className >> r.name >> r.pose.x >> r.pose.y >> r.pose.z >>
+				r.pose.yaw >> r.pose.pitch >> r.pose.roll;
+			break;
+		case Kind::ResetCollisionFlag:
+		case Kind::Despawn:
+			break;
+		default:
+			THROW_EXCEPTION_FMT("Unknown input kind: %u", kind);
+	};
+	return r;
+}
+
+void World::internal_apply_input(const TExternalInput& in)
+{
+	using Kind = TExternalInput::Kind;
+
+	const auto record = [&]() {
+		if (!m_input_log) return;
+		auto out = mrpt::serialization::archiveFrom(*m_input_log);
+		writeInput(out, m_timestep_count - m_input_log_first_step, in);
+	};
+
+	// The only input not addressed to an existing object:
+	if (in.kind == Kind::Spawn)
+	{
+		if (const auto err = internal_check_spawn(in.className, in.name);
+			!err.empty())
+		{
+			MRPT_LOG_ERROR_STREAM("Ignoring spawn input: " << err);
+			return;
+		}
+		record();
+		internal_spawn(in);
+		return;
+	}
+
+	Simulable* obj = getObjectByHandle(in.object);
+	if (!obj) return;
+	if (in.kind == Kind::Despawn && !internal_can_despawn(in.object)) return;
+
+	record();
+
+	switch (in.kind)
+	{
+		case Kind::SetPose:
+		case Kind::SetPoseRelative:
+			if (in.kind == Kind::SetPoseRelative)
+				obj->setPose((mrpt::poses::CPose3D(obj->getPose()) +
+							  mrpt::poses::CPose3D(in.pose))
+								 .asTPose());
+			else
+				obj->setPose(in.pose);
+			obj->resetCollisionFlag();
+			internal_update_hot_state(in.object);
+			break;
+
+		case Kind::ResetCollisionFlag:
+			obj->resetCollisionFlag();
+			internal_update_hot_state(in.object);
+			break;
+
+		case Kind::TwistCommand:
+		case Kind::TeleopKey:
+		{
+			auto* veh = dynamic_cast<VehicleBase*>(obj);
+			if (!veh) break;
+			ControllerBaseInterface* controller = veh->getControllerInterface();
+
+			if (in.kind == Kind::TwistCommand)
+			{
+				if (!controller->setTwistCommand(in.vx, in.wz))
+				{
+					MRPT_LOG_DEBUG_FMT(
+						"Controller of vehicle '%s' refuses Twist commands",
+						veh->getName().c_str());
+					if (in.onRefused) in.onRefused();
+				}
+			}
+			else
+			{
+				ControllerBaseInterface::TeleopInput teleop_in;
+				ControllerBaseInterface::TeleopOutput teleop_out;
+				teleop_in.keycode = in.keycode;
+				controller->teleop_interface(teleop_in, teleop_out);
+			}
+		}
+		break;
+
+		case Kind::Despawn:
+			internal_despawn(in.object);
+			break;
+
+		case Kind::Spawn:
+			break;	// Handled above
+	};
+}
+
+void World::startInputRecording(const std::string& fileName)
+{
+	MRPT_START
+
+	stopInputRecording();
+
+	auto f = std::make_shared<mrpt::io::CFileGZOutputStream>();
+	if (!f->open(fileName))
+		THROW_EXCEPTION_FMT("Error creating file '%s'", fileName.c_str());
+
+	std::lock_guard<std::mutex> lck(m_simulationStepRunningMtx);
+
+	const auto state = internal_save_state();
+
+	auto out = mrpt::serialization::archiveFrom(*f);
+	out << std::string(INPUT_LOG_MAGIC) << INPUT_LOG_FORMAT_VERSION
+		<< m_simul_timestep << (m_timestep_count == 0)
+		<< static_cast<uint32_t>(state.size());
+	out.WriteBuffer(state.data(), state.size());
+
+	m_input_log = std::move(f);
+	m_input_log_first_step = m_timestep_count;
+	m_input_recording = true;
+
+	MRPT_END
+}
+
+void World::stopInputRecording()
+{
+	std::lock_guard<std::mutex> lck(m_simulationStepRunningMtx);
+	if (!m_input_log) return;
+
+	auto out = mrpt::serialization::archiveFrom(*m_input_log);
+	out << static_cast<uint8_t>(LogRecord::End)
+		<< (m_timestep_count - m_input_log_first_step)
+		<< mrpt::system::compute_CRC32(internal_save_state());
+
+	m_input_log.reset();
+	m_input_recording = false;
+}
+
+bool World::replayInputLog(const std::string& fileName)
+{
+	MRPT_START
+
+	mrpt::io::CFileGZInputStream f;
+	if (!f.open(fileName))
+		THROW_EXCEPTION_FMT("Error reading from file '%s'", fileName.c_str());
+
+	auto in = mrpt::serialization::archiveFrom(f);
+
+	std::string magic;
+	in >> magic;
+	ASSERTMSG_(
+		magic == INPUT_LOG_MAGIC,
+		mrpt::format("'%s' is not an input log file", fileName.c_str()));
+
+	uint8_t version;
+	in >> version;
+	ASSERT_EQUAL_(version, INPUT_LOG_FORMAT_VERSION);
+
+	double dt;
+	bool fromStart;
+	uint32_t stateSize;
+	in >> dt >> fromStart >> stateSize;
+	std::vector<uint8_t> state(stateSize);
+	ASSERT_EQUAL_(in.ReadBuffer(state.data(), stateSize), stateSize);
+
+	std::vector<std::pair<uint64_t, TExternalInput>> inputs;
+	uint64_t endStep = 0;
+	uint32_t endCRC = 0;
+	bool hasEnd = false;
+	try
+	{
+		while (!hasEnd)
+		{
+			uint8_t rec;
+			uint64_t step;
+			in >> rec >> step;
+			if (static_cast<LogRecord>(rec) == LogRecord::End)
+			{
+				in >> endCRC;
+				endStep = step;
+				hasEnd = true;
+			}
+			else
+				inputs.emplace_back(step, readInput(in));
+		}
+	}
+	catch (const std::exception&)
+	{
+		// E.g. the recording process crashed:
+		MRPT_LOG_WARN_FMT(
+			"Input log '%s' is truncated: replaying up to its last input",
+			fileName.c_str());
+		if (!inputs.empty()) endStep = inputs.back().first + 1;
+	}
+
+	// Do not mix with other sources of timesteps or inputs:
+	pauseSimulation();
+	stopInputRecording();
+
+	set_simul_timestep(dt);
+	{
+		std::lock_guard<std::mutex> lck(m_simulationStepRunningMtx);
+
+		// A world freshly loaded has the exact Box2D state of the recording
+		// one, which restoring the snapshot would not give:
+		const bool isFresh = fromStart && m_timestep_count == 0 &&
+							 mrpt::system::compute_CRC32(
+								 internal_save_state()) ==
+								 mrpt::system::compute_CRC32(state);
+		if (!isFresh) internal_restore_state(state);
+	}
+
+	size_t next = 0;
+	for (uint64_t step = 0; step < endStep; step++)
+	{
+		for (; next < inputs.size() && inputs[next].first == step; next++)
+			enqueueInput(inputs[next].second);
+
+		internal_one_timestep(m_simul_timestep);
+	}
+
+	if (!hasEnd) return false;
+
+	const bool identical =
+		mrpt::system::compute_CRC32(saveState()) == endCRC;
+	if (!identical)
+		MRPT_LOG_WARN("Replayed final state differs from the recorded one");
+
+	return identical;
+
+	MRPT_END
+}
@@ -0,0 +1,237 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mrpt/core/lock_helper.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mvsim/World.h>
+
+using namespace mvsim;
+
+World::ObjectHandle World::spawn(
+	const std::string& className, const std::string& name,
+	const mrpt::math::TPose3D& pose)
+{
+	MRPT_START
+
+	std::lock_guard<std::mutex> lck(m_simulationStepRunningMtx);
+
+	if (const auto err = internal_check_spawn(className, name); !err.empty())
+		THROW_EXCEPTION(err);
+
+	TExternalInput in;
+	in.kind = TExternalInput::Kind::Spawn;
+	in.className = className;
+	in.name = name;
+	in.pose = pose;
+	internal_apply_input(in);
+
+	return getObjectHandle(name);
+
+	MRPT_END
+}
+
+bool World::despawn(const std::string& name)
+{
+	std::lock_guard<std::mutex> lck(m_simulationStepRunningMtx);
+
+	TExternalInput in;
+	in.kind = TExternalInput::Kind::Despawn;
+	in.object = getObjectHandle(name);
+	if (!internal_can_despawn(in.object)) return false;
+
+	internal_apply_input(in);
+	return true;
+}
+
+std::string World::internal_check_spawn(
+	const std::string& className, const std::string& name) const
+{
+	if (!VehicleBase::is_registered_class(className) &&
+		!Block::is_registered_class(className))
+		return mrpt::format(
+			"No vehicle or block class named '%s'", className.c_str());
+
+	// It goes into an XML attribute, see internal_spawn():
+	if (name.empty() || name.find_first_of("\"<>&") != std::string::npos)
+		return mrpt::format("Invalid object name '%s'", name.c_str());
+
+	if (m_object_names.count(name))
+		return mrpt::format("Object name '%s' already in use", name.c_str());
+
+	return {};
+}
+
+bool World::internal_can_despawn(ObjectHandle h) const
+{
+	const Simulable* s = getObjectByHandle(h);
+	return s && (dynamic_cast<const VehicleBase*>(s) ||
+				 dynamic_cast<const Block*>(s));
+}
+
+void World::internal_spawn(const TExternalInput& in, ObjectHandle h)
+{
+	MRPT_START
+
+	auto lck = mrpt::lockHelper(m_world_cs);
+
+	const bool isVehicle = VehicleBase::is_registered_class(in.className);
+	TSpawnPool& pool = m_spawn_pools[in.className];
+
+	Simulable::Ptr obj;
+	if (!pool.objects.empty())
+	{
+		// Reuse a despawned object, with its Box2D body and 3D models:
+		obj = std::move(pool.objects.back());
+		pool.objects.pop_back();
+
+		mrpt::io::CMemoryStream buf;
+		buf.assignMemoryNotOwn(
+			pool.fresh_state.data(), pool.fresh_state.size());
+		auto arch = mrpt::serialization::archiveFrom(buf);
+		obj->restoreState(arch);
+
+		if (isVehicle)
+			std::dynamic_pointer_cast<VehicleBase>(obj)->recycleAs(
+				in.name, in.className);
+		else
+			std::dynamic_pointer_cast<Block>(obj)->recycleAs(
+				in.name, in.className);
+
+		obj->b2d_body()->SetActive(true);
+	}
+	else
+	{
+		// As a <vehicle> or <block> entry in a world file:
+		const char* tag = isVehicle ? "vehicle" : "block";
+		const std::string xml = mrpt::format(
+			"<%s name=\"%s\" class=\"%s\"><init_pose>0 0 0</init_pose></%s>",
+			tag, in.name.c_str(), in.className.c_str(), tag);
+
+		if (isVehicle)
+			obj = VehicleBase::factory(this, xml);
+		else
+			obj = Block::factory(this, xml);
+
+		if (pool.fresh_state.empty())
+		{
+			mrpt::io::CMemoryStream buf;
+			auto arch = mrpt::serialization::archiveFrom(buf);
+			obj->saveState(arch);
+
+			const auto* data =
+				reinterpret_cast<const uint8_t*>(buf.getRawBufferData());
+			pool.fresh_state.assign(data, data + buf.getTotalBytesCount());
+		}
+	}
+
+	// Written into Box2D before the next timestep:
+	obj->setPose(in.pose);
+
+	if (isVehicle)
+	{
+		auto veh = std::dynamic_pointer_cast<VehicleBase>(obj);
+		veh->setVehicleIndex(internal_unused_vehicle_index());
+		m_vehicles.insert(VehicleList::value_type(veh->getName(), veh));
+		internal_insert_simulable(veh, h);
+	}
+	else
+		insertBlock(std::dynamic_pointer_cast<Block>(obj), h);
+
+	m_spawn_classes[obj.get()] = in.className;
+
+	// Only topics not advertised yet (e.g. of a new name) are registered:
+	if (m_connected_to_server) obj->registerOnServer(m_client);
+
+	MRPT_LOG_DEBUG_FMT(
+		"Spawned '%s' of class '%s' (%zu more in pool)", in.name.c_str(),
+		in.className.c_str(), pool.objects.size());
+
+	MRPT_END
+}
+
+// Removes the entry of obj from a multimap of objects by name:
+template <class LIST>
+static typename LIST::mapped_type eraseFrom(LIST& lst, const Simulable* obj)
+{
+	for (auto it = lst.begin(); it != lst.end(); ++it)
+	{
+		const Simulable* o = it->second.get();
+		if (o != obj) continue;
+
+		auto ret = std::move(it->second);
+		lst.erase(it);
+		return ret;
+	}
+	return {};
+}
+
+void World::internal_despawn(ObjectHandle h)
+{
+	MRPT_START
+
+	auto lck = mrpt::lockHelper(m_world_cs);
+
+	// Its sensors may still be running in the background:
+	m_task_scheduler.wait_pipelined();
+
+	Simulable* s = getObjectByHandle(h);
+	ASSERT_(s);
+
+	Simulable::Ptr obj = eraseFrom(m_simulableObjects, s);
+	ASSERT_(obj);
+	if (auto veh = eraseFrom(m_vehicles, s); veh)
+		veh->setFrictionBatch(nullptr);
+	else
+		eraseFrom(m_blocks, s);
+
+	if (auto it = m_object_names.find(s->getName());
+		it != m_object_names.end() && it->second == h)
+		m_object_names.erase(it);
+	m_object_table[h] = nullptr;
+	m_free_handles.insert(h);
+	m_object_names_changed = true;
+
+	m_task_scheduler_outdated = true;
+	m_friction_batch_outdated = true;
+	m_kinematic_lite_outdated = true;
+	m_lod_outdated = true;
+
+	// Out of contacts and collision queries, but ready to be reused:
+	if (obj->b2d_body()) obj->b2d_body()->SetActive(false);
+
+	if (auto vis = std::dynamic_pointer_cast<VisualObject>(obj);
+		vis && m_gui_thread_running)
+	{
+		std::lock_guard<std::mutex> lck2(m_gui_despawned_mtx);
+		m_gui_despawned.push_back(vis);
+	}
+
+	if (auto it = m_spawn_classes.find(s); it != m_spawn_classes.end())
+	{
+		TSpawnPool& pool = m_spawn_pools[it->second];
+		if (pool.objects.size() < m_spawn_pool_max)
+		{
+			pool.objects.push_back(std::move(obj));
+			return;
+		}
+		m_spawn_classes.erase(it);
+	}
+
+	// Not created by spawn(), or its pool is full:
+	internal_release(std::move(obj));
+
+	MRPT_END
+}
+
+void World::internal_release(Simulable::Ptr&& obj)
+{
+	if (b2Body* b = obj->b2d_body(); b) m_box2d_world->DestroyBody(b);
+	obj.reset();
+}
@@ -0,0 +1,197 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/io/vector_loadsave.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mvsim/World.h>
+
+using namespace mvsim;
+
+// Increment upon any change in the binary format:
+static const uint8_t STATE_FORMAT_VERSION = 3;
+
+std::vector<uint8_t> World::saveState()
+{
+	std::lock_guard<std::mutex> lck(m_simulationStepRunningMtx);
+	return internal_save_state();
+}
+
+std::vector<uint8_t> World::internal_save_state()
+{
+	// Sensors may still be running in the background:
+	m_task_scheduler.wait_pipelined();
+
+	mrpt::io::CMemoryStream buf;
+	auto out = mrpt::serialization::archiveFrom(buf);
+
+	out << STATE_FORMAT_VERSION << m_simul_time << m_timestep_count;
+
+	// The object table, with the class of objects created by spawn() (empty
+	// for those from the world file), so they can be created again:
+	out << static_cast<uint32_t>(m_object_table.size());
+	for (const Simulable* s : m_object_table)
+	{
+		out << static_cast<uint8_t>(s ? 1 : 0);
+		if (!s) continue;
+
+		const auto it = m_spawn_classes.find(s);
+		out << s->getName()
+			<< (it != m_spawn_classes.end() ? it->second : std::string());
+	}
+
+	for (const Simulable* s : m_object_table)
+		if (s) s->saveState(out);
+
+	const auto* data =
+		reinterpret_cast<const uint8_t*>(buf.getRawBufferData());
+	return std::vector<uint8_t>(data, data + buf.getTotalBytesCount());
+}
+
+void World::restoreState(const std::vector<uint8_t>& state)
+{
+	std::lock_guard<std::mutex> lck(m_simulationStepRunningMtx);
+	internal_restore_state(state);
+}
+
+void World::internal_restore_state(const std::vector<uint8_t>& state)
+{
+	MRPT_START
+
+	m_task_scheduler.wait_pipelined();
+
+	mrpt::io::CMemoryStream buf;
+	buf.assignMemoryNotOwn(state.data(), state.size());
+	auto in = mrpt::serialization::archiveFrom(buf);
+
+	uint8_t version;
+	in >> version;
+	ASSERT_EQUAL_(version, STATE_FORMAT_VERSION);
+
+	double simulTime;
+	uint64_t timestepCount;
+	in >> simulTime >> timestepCount;
+
+	struct TEntry
+	{
+		bool present = false;
+		std::string name, className;
+	};
+	uint32_t nHandles;
+	in >> nHandles;
+	std::vector<TEntry> table(nHandles);
+	for (auto& e : table)
+	{
+		uint8_t present;
+		in >> present;
+		e.present = present != 0;
+		if (e.present) in >> e.name >> e.className;
+	}
+
+	// Whether the object with handle h is not the saved one:
+	auto isOutdated = [&](ObjectHandle h) {
+		if (h >= table.size() || !table[h].present) return true;
+
+		const Simulable* s = m_object_table[h];
+		const auto it = m_spawn_classes.find(s);
+		return table[h].name != s->getName() ||
+			   table[h].className !=
+				   (it != m_spawn_classes.end() ? it->second : std::string());
+	};
+
+	// Check everything before modifying the world:
+	for (ObjectHandle h = 0; h < m_object_table.size(); h++)
+	{
+		if (!m_object_table[h] || !isOutdated(h)) continue;
+		ASSERTMSG_(
+			internal_can_despawn(h),
+			mrpt::format(
+				"Object '%s' of this world is not in the saved state",
+				m_object_table[h]->getName().c_str()));
+	}
+	for (ObjectHandle h = 0; h < table.size(); h++)
+	{
+		const TEntry& e = table[h];
+		if (!e.present || (getObjectByHandle(h) && !isOutdated(h))) continue;
+		ASSERTMSG_(
+			!e.className.empty(),
+			mrpt::format(
+				"Object '%s' of the saved state is not in this world (was it "
+				"saved from another world file?)",
+				e.name.c_str()));
+		ASSERTMSG_(
+			VehicleBase::is_registered_class(e.className) ||
+				Block::is_registered_class(e.className),
+			mrpt::format(
+				"Object '%s' of the saved state has an unknown class '%s'",
+				e.name.c_str(), e.className.c_str()));
+	}
+
+	// Objects spawned or despawned since the state was saved:
+	for (ObjectHandle h = 0; h < m_object_table.size(); h++)
+		if (m_object_table[h] && isOutdated(h)) internal_despawn(h);
+
+	for (ObjectHandle h = 0; h < table.size(); h++)
+	{
+		const TEntry& e = table[h];
+		if (!e.present || getObjectByHandle(h)) continue;
+
+		const auto err = internal_check_spawn(e.className, e.name);
+		ASSERTMSG_(err.empty(), err);
+
+		TExternalInput sp;
+		sp.kind = TExternalInput::Kind::Spawn;
+		sp.className = e.className;
+		sp.name = e.name;
+		internal_spawn(sp, h);
+	}
+
+	// Same free handles as the saved world, so the next objects spawned get
+	// the same handles too:
+	for (auto h = m_object_table.size(); h < table.size(); h++)
+		m_free_handles.insert(static_cast<ObjectHandle>(h));
+	m_free_handles.erase(
+		m_free_handles.lower_bound(nHandles), m_free_handles.end());
+	m_object_table.resize(nHandles);
+	m_hot_state.pose.resize(nHandles);
+	m_hot_state.twist.resize(nHandles);
+	m_hot_state.in_collision.resize(nHandles);
+	m_hot_state.had_collision.resize(nHandles);
+
+	for (Simulable* s : m_object_table)
+		if (s) s->restoreState(in);
+
+	m_simul_time = simulTime;
+	m_timestep_count = timestepCount;
+
+	// Sensor timers may have changed:
+	m_task_scheduler_outdated = true;
+
+	m_hot_state.simul_time = m_simul_time;
+	for (ObjectHandle h = 0; h < m_object_table.size(); h++)
+		if (m_object_table[h]) internal_update_hot_state(h);
+	internal_publish_hot_state();
+
+	MRPT_END
+}
+
+void World::saveStateToFile(const std::string& fileName)
+{
+	const auto state = saveState();
+	if (!mrpt::io::vectorToBinaryFile(state, fileName))
+		THROW_EXCEPTION_FMT("Error writing to file '%s'", fileName.c_str());
+}
+
+void World::restoreStateFromFile(const std::string& fileName)
+{
+	std::vector<uint8_t> state;
+	if (!mrpt::io::loadBinaryFile(state, fileName))
+		THROW_EXCEPTION_FMT("Error reading from file '%s'", fileName.c_str());
+	restoreState(state);
+}
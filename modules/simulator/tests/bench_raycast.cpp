@@ -0,0 +1,44 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+/* Benchmarks ScanRayCaster against one b2World::RayCast() per ray (as
+ * LaserScanner used to do) on the same scene. See test_raycast.cpp for the
+ * check that both give the same ranges.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "raycast_scene.h"
+
+using namespace mvsim::test;
+
+namespace
+{
+template <class RAY_CASTER>
+void BM_Scan(benchmark::State& state)
+{
+	Scene& scene = theScene();
+	RAY_CASTER caster;
+	std::vector<double> range;
+
+	size_t p = 0;
+	for (auto _ : state)
+	{
+		caster.scan(scene.world, scene.sensorPt[p], scene.sensorPhi[p], range);
+		benchmark::DoNotOptimize(range.data());
+		p = (p + 1) % NUM_POSES;
+	}
+	state.SetItemsProcessed(state.iterations() * NUM_RAYS);
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_Scan, Box2DRayCaster);
+BENCHMARK_TEMPLATE(BM_Scan, GatheredRayCaster);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,193 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#pragma once
+
+/* A Box2D scene to compare ScanRayCaster with one b2World::RayCast() per
+ * ray, as LaserScanner used to do. See test_raycast.cpp and
+ * bench_raycast.cpp.
+ */
+
+#include <Box2D/Box2D.h>
+#include <mvsim/RandomEngine.h>
+#include <mvsim/basic_types.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Sensors/ScanRayCaster.h"
+
+namespace mvsim::test
+{
+const double ROOM_SIZE = 30.0;
+const double MAX_RANGE = 12.0;
+const double APERTURE = 1.5 * M_PI;
+const size_t NUM_RAYS = 541;
+const size_t NUM_POSES = 16;
+const double RANGE_TOLERANCE = 1e-3;
+
+/** A world with walls, boxes, circles and loose edges, some of them
+ * invisible, and the sensor poses to test from. */
+struct Scene
+{
+	b2World world{b2Vec2(0, 0)};
+	std::vector<b2Vec2> sensorPt;
+	std::vector<double> sensorPhi;
+
+	Scene()
+	{
+		RandomEngine rng(1234);
+		std::uniform_real_distribution<double> unif(0.0, 1.0);
+		auto inRoom = [&]() {
+			return static_cast<float32>((unif(rng) - 0.5) * ROOM_SIZE);
+		};
+
+		b2BodyDef bdef;
+		b2Body* ground = world.CreateBody(&bdef);
+
+		// Room walls:
+		const float32 h = 0.5 * ROOM_SIZE;
+		const b2Vec2 corners[4] = {
+			b2Vec2(-h, -h), b2Vec2(h, -h), b2Vec2(h, h), b2Vec2(-h, h)};
+		b2ChainShape walls;
+		walls.CreateLoop(corners, 4);
+		ground->CreateFixture(&walls, 0);
+
+		// Loose edges:
+		for (int i = 0; i < 10; i++)
+		{
+			b2EdgeShape edge;
+			edge.Set(b2Vec2(inRoom(), inRoom()), b2Vec2(inRoom(), inRoom()));
+			ground->CreateFixture(&edge, 0);
+		}
+
+		// Boxes and circles, each in its own body. One in five of them is
+		// invisible to sensors:
+		for (int i = 0; i < 60; i++)
+		{
+			bdef.type = (i % 2) ? b2_dynamicBody : b2_staticBody;
+			bdef.position.Set(inRoom(), inRoom());
+			bdef.angle = 2 * M_PI * unif(rng);
+			b2Body* body = world.CreateBody(&bdef);
+
+			b2Fixture* f;
+			if (i % 3)
+			{
+				b2PolygonShape box;
+				box.SetAsBox(0.1 + unif(rng), 0.1 + unif(rng));
+				f = body->CreateFixture(&box, 1);
+			}
+			else
+			{
+				b2CircleShape circle;
+				circle.m_radius = 0.1 + 0.5 * unif(rng);
+				f = body->CreateFixture(&circle, 1);
+			}
+			if (i % 5 == 0) f->SetUserData(INVISIBLE_FIXTURE_USER_DATA);
+		}
+
+		for (size_t i = 0; i < NUM_POSES; i++)
+		{
+			sensorPt.emplace_back(inRoom(), inRoom());
+			sensorPhi.push_back(2 * M_PI * unif(rng));
+		}
+	}
+
+	/** Angle of ray \a i, relative to the sensor */
+	static double rayAngle(size_t i)
+	{
+		return -0.5 * APERTURE + i * APERTURE / (NUM_RAYS - 1);
+	}
+};
+
+/** One b2World::RayCast() per ray, as LaserScanner used to do. Misses are
+ * set to MAX_RANGE + 1 */
+class Box2DRayCaster
+{
+   public:
+	void scan(
+		const b2World& world, const b2Vec2& sensorPt, double phi,
+		std::vector<double>& outRange)
+	{
+		outRange.resize(NUM_RAYS);
+		for (size_t i = 0; i < NUM_RAYS; i++)
+		{
+			const double A = phi + Scene::rayAngle(i);
+			const b2Vec2 endPt = b2Vec2(
+				sensorPt.x + cos(A) * MAX_RANGE,
+				sensorPt.y + sin(A) * MAX_RANGE);
+
+			m_callback.m_hit = false;
+			world.RayCast(&m_callback, sensorPt, endPt);
+
+			outRange[i] = m_callback.m_hit
+							  ? (m_callback.m_point - sensorPt).Length()
+							  : MAX_RANGE + 1.0;
+		}
+	}
+
+   private:
+	/** Finds the closest hit, skipping invisible fixtures */
+	class RayCastClosestCallback : public b2RayCastCallback
+	{
+	   public:
+		float32 ReportFixture(
+			b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal,
+			float32 fraction) override
+		{
+			if (fixture->GetUserData() == INVISIBLE_FIXTURE_USER_DATA)
+				return -1.0f;  // Ignore it, go on with the next one
+
+			m_hit = true;
+			m_point = point;
+			return fraction;  // Clip the ray
+		}
+
+		bool m_hit = false;
+		b2Vec2 m_point;
+	};
+
+	RayCastClosestCallback m_callback;
+};
+
+/** All rays at once, as LaserScanner does now */
+class GatheredRayCaster
+{
+   public:
+	void scan(
+		const b2World& world, const b2Vec2& sensorPt, double phi,
+		std::vector<double>& outRange)
+	{
+		m_dx.resize(NUM_RAYS);
+		m_dy.resize(NUM_RAYS);
+		outRange.resize(NUM_RAYS);
+		for (size_t i = 0; i < NUM_RAYS; i++)
+		{
+			const double A = phi + Scene::rayAngle(i);
+			m_dx[i] = std::cos(A);
+			m_dy[i] = std::sin(A);
+		}
+
+		m_caster.gather(world, sensorPt.x, sensorPt.y, MAX_RANGE);
+		m_caster.cast(m_dx.data(), m_dy.data(), NUM_RAYS, outRange.data());
+	}
+
+   private:
+	ScanRayCaster m_caster;
+	std::vector<double> m_dx, m_dy;
+};
+
+inline Scene& theScene()
+{
+	static Scene scene;
+	return scene;
+}
+
+}  // namespace mvsim::test
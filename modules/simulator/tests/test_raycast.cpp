@@ -0,0 +1,75 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+/* Checks that ScanRayCaster gives the same ranges than one b2World::RayCast()
+ * per ray (as LaserScanner used to do). Returns non-zero if any range differs.
+ * See bench_raycast.cpp for their timings.
+ */
+
+#include <cstdio>
+#include <exception>
+
+#include "raycast_scene.h"
+
+using namespace mvsim::test;
+
+/** Returns the number of rays whose hit/miss or range differ */
+static size_t checkSameRanges()
+{
+	Scene& scene = theScene();
+	Box2DRayCaster ref;
+	GatheredRayCaster dut;
+	std::vector<double> refRange, dutRange;
+
+	size_t nHits = 0, nBad = 0;
+	for (size_t p = 0; p < NUM_POSES; p++)
+	{
+		ref.scan(scene.world, scene.sensorPt[p], scene.sensorPhi[p], refRange);
+		dut.scan(scene.world, scene.sensorPt[p], scene.sensorPhi[p], dutRange);
+
+		for (size_t i = 0; i < NUM_RAYS; i++)
+		{
+			const bool refHit = refRange[i] <= MAX_RANGE;
+			const bool dutHit = dutRange[i] <= MAX_RANGE;
+			if (refHit) nHits++;
+
+			if (refHit == dutHit &&
+				(!refHit ||
+				 std::abs(refRange[i] - dutRange[i]) <= RANGE_TOLERANCE))
+				continue;
+
+			nBad++;
+			fprintf(
+				stderr,
+				"Pose #%u ray #%u: b2World::RayCast()=%f "
+				"ScanRayCaster=%f (misses are >%.01f)\n",
+				static_cast<unsigned>(p), static_cast<unsigned>(i),
+				refRange[i], dutRange[i], MAX_RANGE);
+		}
+	}
+
+	printf(
+		"Checked %u rays (%u hits): %u with different ranges.\n",
+		static_cast<unsigned>(NUM_POSES * NUM_RAYS),
+		static_cast<unsigned>(nHits), static_cast<unsigned>(nBad));
+	return nBad;
+}
+
+int main()
+{
+	try
+	{
+		return checkSameRanges() == 0 ? 0 : 1;
+	}
+	catch (const std::exception& e)
+	{
+		fprintf(stderr, "Error: %s\n", e.what());
+		return 1;
+	}
+}
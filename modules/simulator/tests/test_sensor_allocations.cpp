@@ -0,0 +1,169 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+/* Checks that, once warmed up, sensors do no heap allocations per reading
+ * (see ObservationPool), including publishing them. The World is stepped as
+ * usual, and the calls to operator new from the simulation thread counted.
+ */
+
+#include <gtest/gtest.h>
+#include <mvsim/Comms/Server.h>
+#include <mvsim/Sensors/LaserScanner.h>
+#include <mvsim/VehicleBase.h>
+#include <mvsim/World.h>
+
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+using namespace mvsim;
+
+namespace
+{
+// Only those of this thread: ZMQ and the server have their own threads.
+thread_local size_t numAllocations = 0;
+
+void* countedMalloc(std::size_t size)
+{
+	numAllocations++;
+	if (void* p = std::malloc(size ? size : 1); p) return p;
+	throw std::bad_alloc();
+}
+}  // namespace
+
+void* operator new(std::size_t size) { return countedMalloc(size); }
+void* operator new[](std::size_t size) { return countedMalloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace
+{
+// One moving robot with a laser scanner which publishes its scans, and some
+// obstacles around. Simulated in the calling thread:
+const char* WORLD_XML = R"XML(
+<mvsim_world version="1.0">
+	<simul_timestep>0.005</simul_timestep>
+	<simul_threads>1</simul_threads>
+	<sensors_pipelined>false</sensors_pipelined>
+
+	<vehicle:class name="robot">
+		<dynamics class="differential">
+			<l_wheel pos="0.0  0.5" mass="4.0" width="0.20" diameter="0.40" />
+			<r_wheel pos="0.0 -0.5" mass="4.0" width="0.20" diameter="0.40" />
+			<chassis mass="15.0" zmin="0.05" zmax="0.6"></chassis>
+			<controller class="twist_pid">
+				<KP>100</KP> <KI>5</KI> <I_MAX>10</I_MAX> <KD>0</KD>
+				<V>0.5</V> <W>0.2</W>
+				<max_torque>25</max_torque>
+			</controller>
+		</dynamics>
+		<sensor class="laser" name="laser1">
+			<pose> 0.3  0.0  0.0 </pose>
+			<fov_degrees>270</fov_degrees>
+			<nrays>541</nrays>
+			<sensor_period>0.1</sensor_period>
+			<publish>
+				<publish_topic>/${PARENT_NAME}/${NAME}</publish_topic>
+			</publish>
+		</sensor>
+	</vehicle:class>
+
+	<block:class name="box">
+		<mass>20</mass>
+		<zmax>1.0</zmax>
+		<shape>
+			<pt>-0.5 -0.5</pt> <pt>-0.5 0.5</pt>
+			<pt> 0.5  0.5</pt> <pt> 0.5 -0.5</pt>
+		</shape>
+	</block:class>
+
+	<vehicle name="r1" class="robot">
+		<init_pose>0 0 0</init_pose>
+	</vehicle>
+
+	<block class="box"> <init_pose>4 0 0</init_pose> </block>
+	<block class="box"> <init_pose>0 5 30</init_pose> </block>
+	<block class="box"> <init_pose>-3 -3 60</init_pose> </block>
+	<block class="box"> <init_pose>6 6 0</init_pose> </block>
+</mvsim_world>
+)XML";
+
+/** Tells which timesteps reported observations */
+class TestWorld : public World
+{
+   public:
+	bool newObservation = false;
+
+	void onNewObservation(
+		[[maybe_unused]] const VehicleBase& veh,
+		[[maybe_unused]] const mrpt::obs::CObservation* obs) override
+	{
+		newObservation = true;
+	}
+};
+}  // namespace
+
+TEST(SensorAllocations, LaserScannerSteadyState)
+{
+#if defined(MVSIM_HAS_ZMQ) && defined(MVSIM_HAS_PROTOBUF)
+	// So scans are also serialized and published:
+	Server server;
+	server.start();
+#endif
+
+	TestWorld world;
+	world.load_from_XML(WORLD_XML);
+
+	auto itVeh = world.getListOfVehicles().find("r1");
+	ASSERT_TRUE(itVeh != world.getListOfVehicles().end());
+	VehicleBase& veh = *itVeh->second;
+	ASSERT_EQ(veh.getSensors().size(), 1u);
+	ASSERT_TRUE(
+		std::dynamic_pointer_cast<LaserScanner>(veh.getSensors().front()));
+
+#if defined(MVSIM_HAS_ZMQ) && defined(MVSIM_HAS_PROTOBUF)
+	world.connectToServer();
+	ASSERT_TRUE(world.isConnectedToServer());
+#endif
+
+	// Warm up: fill the observation pool, grow buffers to their final size
+	const double dt = world.get_simul_timestep();
+	world.run_simulation(1.0);
+
+	// Step by step, as usual (World::internal_one_timestep() running the
+	// TaskScheduler). The rest of the timestep is not under test here, so
+	// each step with a scan is compared to the step right before it, which
+	// does the same but the scan:
+	const size_t NUM_SCANS = 50;
+	size_t numScans = 0, scanAllocations = 0, lastStepAllocations = 0;
+	bool lastStepScanned = true;
+
+	while (numScans < NUM_SCANS)
+	{
+		world.newObservation = false;
+		const size_t n0 = numAllocations;
+		world.run_simulation(dt);
+		const size_t stepAllocations = numAllocations - n0;
+
+		if (world.newObservation)
+		{
+			ASSERT_FALSE(lastStepScanned) << "Sensor period too short";
+			numScans++;
+			if (stepAllocations > lastStepAllocations)
+				scanAllocations += stepAllocations - lastStepAllocations;
+		}
+		lastStepScanned = world.newObservation;
+		lastStepAllocations = stepAllocations;
+	}
+
+	EXPECT_EQ(scanAllocations, 0u)
+		<< "Heap allocations in " << NUM_SCANS << " scans";
+}
@@ -10,6 +10,7 @@
 #include <mrpt/core/exceptions.h>
 #include <mvsim/World.h>
 
+#include <iostream>
 #include <rapidxml_utils.hpp>
 #include <thread>
 
@@ -89,32 +90,14 @@ Available options:
 	std::thread thGUI =
 		std::thread(&mvsim_server_thread_update_GUI, std::ref(thread_params));
 
-	// Run simulation:
-	mrpt::system::CTicTac tictac;
-	double t_old = tictac.Tac();
-	double REALTIME_FACTOR = 1.0;
+	// Run simulation in its own thread, paced with the wall clock:
+	world.runRealtime(1.0);
+
 	bool do_exit = false;
 	size_t teleop_idx_veh = 0;  // Index of the vehicle to teleop
 
 	while (!do_exit && !mrpt::system::os::kbhit())
 	{
-		// Simulation
-		// ============================================================
-		// Compute how much time has passed to simulate in real-time:
-		double t_new = tictac.Tac();
-		double incr_time = REALTIME_FACTOR * (t_new - t_old);
-
-		// Just in case the computer is *really fast*...
-		if (incr_time >= world.get_simul_timestep())
-		{
-			// Simulate:
-			world.run_simulation(incr_time);
-
-			// t_old_simul = world.get_simul_time();
-			t_old = t_new;
-		}
-
-		// I could use 10ms here but chono literals are since gcc 4.9.3
 		std::this_thread::sleep_for(std::chrono::milliseconds(10));
 
 		// GUI msgs, teleop, etc.
@@ -141,7 +124,9 @@ Available options:
 				break;
 		};
 
-		{  // Test: Differential drive: Control raw forces
+		// The simulation runs in its own thread: do not let it modify
+		// vehicles or controllers meanwhile:
+		world.runWithSimulationLocked([&]() {
 			const World::VehicleList& vehs = world.getListOfVehicles();
 			txt2gui_tmp += mrpt::format(
 				"Selected vehicle: %u/%u\n",
@@ -173,16 +158,27 @@ Available options:
 				// Generic teleoperation interface for any controller that
 				// supports it:
 				{
+					// Keys are applied by the simulation thread, so they can
+					// be recorded (see World::startInputRecording()):
+					if (keyevent.keycode != 0)
+					{
+						World::TExternalInput in;
+						in.kind = World::TExternalInput::Kind::TeleopKey;
+						in.object = world.getObjectHandle(
+							it_veh->second->getName());
+						in.keycode = keyevent.keycode;
+						world.enqueueInput(in);
+					}
+
 					ControllerBaseInterface* controller =
 						it_veh->second->getControllerInterface();
 					ControllerBaseInterface::TeleopInput teleop_in;
 					ControllerBaseInterface::TeleopOutput teleop_out;
-					teleop_in.keycode = keyevent.keycode;
 					controller->teleop_interface(teleop_in, teleop_out);
 					txt2gui_tmp += teleop_out.append_gui_lines;
 				}
 			}
-		}
+		});
 
 		// Clear the keystroke buffer
 		gui_key_events_mtx.lock();
@@ -193,6 +189,17 @@ Available options:
 
 	}  // end while()
 
+	world.stopRealtime();
+
+	const auto rtStats = world.getRealtimeStats();
+	std::cout << mrpt::format(
+		"Real-time stats: %lu timesteps, %lu overruns, drift=%.03f ms, "
+		"jitter: mean=%.03f ms std=%.03f ms max=%.03f ms\n",
+		static_cast<unsigned long>(rtStats.timesteps),
+		static_cast<unsigned long>(rtStats.overruns), 1e3 * rtStats.drift,
+		1e3 * rtStats.jitter_mean, 1e3 * rtStats.jitter_std,
+		1e3 * rtStats.jitter_max);
+
 	thread_params.closing(true);
 
 	thGUI.join();  // TODO: It could break smth
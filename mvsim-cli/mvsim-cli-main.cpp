@@ -39,8 +39,11 @@ static const std::map<std::string, cmd_t> cliCommands = {
 	{"help", cmd_t(&printListCommands)},
 	{"server", cmd_t(&launchStandAloneServer)},
 	{"launch", cmd_t(&launchSimulation)},
+	{"run", cmd_t(&runSimulation)},
+	{"replay", cmd_t(&replayInputLog)},
 	{"node", cmd_t(&commandNode)},
 	{"topic", cmd_t(&commandTopic)},
+	{"telemetry", cmd_t(&commandTelemetry)},
 };
 
 int main(int argc, char** argv)
@@ -89,9 +92,15 @@ int printListCommands()
 
 Available commands:
     mvsim launch <WORLD.xml>  Start a comm. server and simulates a world.
+    mvsim run <WORLD.xml>     Simulates a world for a given time, optionally
+                              headless and faster than real-time.
+    mvsim replay <WORLD.xml> <LOG>
+                              Re-runs a log of inputs recorded with
+                              `mvsim run --record`.
     mvsim server              Start a standalone communication server.
     mvsim node                List connected nodes, etc.
     mvsim topic               Inspect, publish, etc. topics.
+    mvsim telemetry <LOG.bin> Exports a binary telemetry log to CSV, etc.
 
 Or use `mvsim <COMMAND> --help` for further options
 )XXX");
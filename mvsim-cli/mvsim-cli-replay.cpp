@@ -0,0 +1,65 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mrpt/system/CTicTac.h>
+#include <mvsim/World.h>
+
+#include <iostream>
+#include <rapidxml_utils.hpp>
+
+#include "mvsim-cli.h"
+
+int replayInputLog()
+{
+	// check args:
+	bool badArgs = false;
+	const auto& unlabeledArgs = argCmd.getValue();
+	if (unlabeledArgs.size() != 3) badArgs = true;
+
+	if (argHelp.isSet() || badArgs)
+	{
+		fprintf(
+			stdout,
+			R"XXX(Usage: mvsim replay <WORLD_MODEL.xml> <LOG> [options]
+
+Re-runs, headless and as fast as possible, a log of inputs recorded with
+`mvsim run --record <LOG>`, and checks whether the final state is identical.
+WORLD_MODEL.xml must be the same file used while recording.
+
+Available options:
+  -v, --verbosity      Set verbosity level: DEBUG, INFO (default), WARN, ERROR
+)XXX");
+		return 0;
+	}
+
+	const auto sXMLfilename = unlabeledArgs.at(1);
+	const auto sLogFilename = unlabeledArgs.at(2);
+
+	mvsim::World world;
+
+	world.setMinLoggingLevel(
+		mrpt::typemeta::TEnumType<mrpt::system::VerbosityLevel>::name2value(
+			argVerbosity.getValue()));
+
+	rapidxml::file<> fil_xml(sXMLfilename.c_str());
+	world.load_from_XML(fil_xml.data(), sXMLfilename.c_str());
+
+	mrpt::system::CTicTac tictac;
+	const bool identical = world.replayInputLog(sLogFilename);
+	const double wallTime = tictac.Tac();
+
+	std::cout << mrpt::format(
+		"Simulated time   : %.03f s\n"
+		"Wall-clock time  : %.03f s\n"
+		"Final state      : %s\n",
+		world.get_simul_time(), wallTime,
+		identical ? "identical to the recorded run" : "DIFFERENT");
+
+	return identical ? 0 : 1;
+}
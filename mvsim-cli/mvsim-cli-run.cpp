@@ -0,0 +1,193 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mrpt/core/exceptions.h>
+#include <mrpt/system/CTicTac.h>
+#include <mvsim/World.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <rapidxml_utils.hpp>
+#include <thread>
+
+#include "mvsim-cli.h"
+
+TCLAP::SwitchArg argHeadless(
+	"", "headless", "Runs without GUI nor communications server", cmd);
+
+TCLAP::ValueArg<double> argDuration(
+	"", "duration", "Simulated time to run, in seconds (0=forever)", false,
+	0.0, "seconds", cmd);
+
+TCLAP::ValueArg<std::string> argRTF(
+	"", "rtf", "Real-time factor: a number, or `max` to run as fast as possible",
+	false, "1.0", "RTF", cmd);
+
+TCLAP::ValueArg<unsigned int> argProfile(
+	"", "profile",
+	"Profiles the time spent by each object, and prints the N worst ones at "
+	"the end",
+	false, 0, "N", cmd);
+
+TCLAP::ValueArg<std::string> argRecord(
+	"", "record",
+	"Records all external inputs into a log file, for `mvsim replay`", false,
+	"", "inputs.log", cmd);
+
+int runSimulation()
+{
+	using namespace mvsim;
+
+	// check args:
+	bool badArgs = false;
+	const auto& unlabeledArgs = argCmd.getValue();
+	if (unlabeledArgs.size() != 2) badArgs = true;
+
+	if (argHelp.isSet() || badArgs)
+	{
+		fprintf(
+			stdout,
+			R"XXX(Usage: mvsim run <WORLD_MODEL.xml> [options]
+
+Available options:
+  --headless           Do not open the GUI nor start the comms. server.
+  --duration <T>       Simulated time to run, in seconds (default: 0=forever)
+  --rtf <RTF>          Real-time factor (default: 1.0), or `max` to run
+                       as fast as possible.
+  --profile <N>        Measure the time spent by each object and print the
+                       N most expensive ones at the end.
+  --record <LOG>       Record all external inputs (services, teleop...) to
+                       reproduce this run later with `mvsim replay`.
+  -v, --verbosity      Set verbosity level: DEBUG, INFO (default), WARN, ERROR
+)XXX");
+		return 0;
+	}
+
+	const auto sXMLfilename = unlabeledArgs.at(1);
+	const bool headless = argHeadless.isSet();
+	const double duration = argDuration.getValue();
+
+	// 0 means: as fast as possible
+	double rtf = 0;
+	if (argRTF.getValue() != "max")
+	{
+		rtf = std::stod(argRTF.getValue());
+		ASSERTMSG_(rtf > 0, "--rtf must be a positive number or `max`");
+	}
+
+	if (!headless) commonLaunchServer();
+
+	mvsim::World world;
+
+	world.setMinLoggingLevel(
+		mrpt::typemeta::TEnumType<mrpt::system::VerbosityLevel>::name2value(
+			argVerbosity.getValue()));
+
+	// Load from XML:
+	rapidxml::file<> fil_xml(sXMLfilename.c_str());
+	world.load_from_XML(fil_xml.data(), sXMLfilename.c_str());
+
+	if (!headless) world.connectToServer();
+
+	const unsigned int profileTopN = argProfile.getValue();
+	if (profileTopN > 0) world.enableProfiler();
+
+	if (argRecord.isSet()) world.startInputRecording(argRecord.getValue());
+
+	// In `max` mode: simulated time between checks for GUI events, etc.
+	const double simulChunk = 100 * world.get_simul_timestep();
+
+	mrpt::system::CTicTac tictac;
+	double t_last_gui = -1.0;
+	const double t_start_simul = world.get_simul_time();
+	bool do_exit = false;
+
+	// With a finite RTF, the simulation runs in its own thread:
+	if (rtf > 0)
+	{
+		World::TRealtimeOptions rtOpts;
+		if (duration > 0) rtOpts.end_time = t_start_simul + duration;
+		world.runRealtime(rtf, rtOpts);
+	}
+
+	while (!do_exit)
+	{
+		// If paused, timesteps are driven by the "sim/step" service:
+		if (world.isRealtimeRunning() || world.isPaused())
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		else if (rtf > 0)
+			break;
+		else
+		{
+			const double simulTime = world.get_simul_time() - t_start_simul;
+			if (duration > 0 && simulTime >= duration - 1e-6) break;
+
+			double incr_time = simulChunk;
+			if (duration > 0)
+				incr_time = std::min(incr_time, duration - simulTime);
+
+			world.run_simulation(incr_time);
+		}
+
+		if (headless) continue;
+
+		// GUI refresh:
+		const double t_new = tictac.Tac();
+		if (t_new - t_last_gui < 40e-3) continue;
+		t_last_gui = t_new;
+
+		mvsim::World::TUpdateGUIParams guiparams;
+		guiparams.msg_lines = mrpt::format(
+			"Simulated time: %.03f s", world.get_simul_time());
+		world.update_GUI(&guiparams);
+
+		if (guiparams.keyevent.keycode == GLFW_KEY_ESCAPE ||
+			!world.is_GUI_open())
+			do_exit = true;
+	}
+
+	world.stopRealtime();
+	world.stopInputRecording();
+
+	// Stats:
+	const double wallTime = tictac.Tac();
+	const double simulTime = world.get_simul_time() - t_start_simul;
+	const auto nSteps = static_cast<size_t>(
+		std::round(simulTime / world.get_simul_timestep()));
+
+	std::cout << mrpt::format(
+		"Simulated time   : %.03f s\n"
+		"Wall-clock time  : %.03f s\n"
+		"Timesteps        : %zu\n"
+		"Timesteps/sec    : %.02f\n"
+		"Real-time factor : %.03f\n",
+		simulTime, wallTime, nSteps, nSteps / std::max(wallTime, 1e-9),
+		simulTime / std::max(wallTime, 1e-9));
+
+	if (rtf > 0)
+	{
+		const auto rtStats = world.getRealtimeStats();
+		std::cout << mrpt::format(
+			"Overruns         : %lu\n"
+			"Drift            : %.03f ms (max: %.03f ms)\n"
+			"Timer jitter     : mean=%.03f ms std=%.03f ms max=%.03f ms\n",
+			static_cast<unsigned long>(rtStats.overruns), 1e3 * rtStats.drift,
+			1e3 * rtStats.drift_max, 1e3 * rtStats.jitter_mean,
+			1e3 * rtStats.jitter_std, 1e3 * rtStats.jitter_max);
+	}
+
+	if (profileTopN > 0)
+		std::cout << "\nPer-object profiler:\n"
+				  << world.getProfilerReport(profileTopN);
+
+	return 0;
+}
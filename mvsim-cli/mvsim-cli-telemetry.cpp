@@ -0,0 +1,131 @@
+/*+-------------------------------------------------------------------------+
+  |                       MultiVehicle simulator (libmvsim)                 |
+  |                                                                         |
+  | Copyright (C) 2014-2020  Jose Luis Blanco Claraco                       |
+  | Copyright (C) 2017  Borys Tymchenko (Odessa Polytechnic University)     |
+  | Distributed under 3-clause BSD License                                  |
+  |   See COPYING                                                           |
+  +-------------------------------------------------------------------------+ */
+
+#include <mrpt/core/exceptions.h>
+#include <mrpt/system/filesystem.h>
+#include <mvsim/TelemetryLog.h>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+#include "mvsim-cli.h"
+
+TCLAP::ValueArg<std::string> argTelemetryOutput(
+	"o", "output",
+	"Output file (csv) or directory (columns). Default: next to the input",
+	false, "", "OUTPUT", cmd);
+
+TCLAP::ValueArg<std::string> argTelemetryFormat(
+	"", "format", "Export format: `csv` (default) or `columns`", false, "csv",
+	"FORMAT", cmd);
+
+int commandTelemetry()
+{
+	// check args:
+	bool badArgs = false;
+	const auto& unlabeledArgs = argCmd.getValue();
+	if (unlabeledArgs.size() != 2) badArgs = true;
+
+	const std::string format = argTelemetryFormat.getValue();
+	if (format != "csv" && format != "columns") badArgs = true;
+
+	if (argHelp.isSet() || badArgs)
+	{
+		fprintf(
+			stdout,
+			R"XXX(Usage: mvsim telemetry <LOG.bin> [options]
+
+Exports a binary telemetry log (vehicles with <log_format>binary</log_format>).
+
+Available options:
+  -o, --output <OUT>   Output file or directory. Default: LOG.csv or LOG/
+  --format <FORMAT>    `csv` (default): one text file, one row per line.
+                       `columns`: a directory with one file per column,
+                       each a raw array of little-endian doubles (e.g. for
+                       numpy.fromfile()).
+)XXX");
+		return badArgs ? 1 : 0;
+	}
+
+	const std::string inFile = unlabeledArgs.at(1);
+
+	mvsim::TelemetryReader reader;
+	reader.open(inFile);
+	const auto& names = reader.getColumns();
+
+	std::string out = argTelemetryOutput.getValue();
+	if (out.empty())
+	{
+		// Input file name without extension:
+		out = mrpt::system::extractFileDirectory(inFile) +
+			  mrpt::system::extractFileName(inFile);
+		if (format == "csv") out += ".csv";
+	}
+
+	std::ofstream csv;
+	std::vector<std::unique_ptr<std::ofstream>> colFiles;
+
+	if (format == "csv")
+	{
+		csv.open(out);
+		if (!csv.is_open())
+			THROW_EXCEPTION_FMT("Error creating file '%s'", out.c_str());
+
+		for (size_t i = 0; i < names.size(); i++)
+			csv << (i > 0 ? ", " : "") << names[i];
+		csv << "\n";
+		csv.precision(17);
+	}
+	else
+	{
+		if (!mrpt::system::directoryExists(out) &&
+			!mrpt::system::createDirectory(out))
+			THROW_EXCEPTION_FMT("Error creating directory '%s'", out.c_str());
+
+		for (const auto& name : names)
+		{
+			const std::string f = out + "/" + name + ".f64";
+			colFiles.emplace_back(
+				std::make_unique<std::ofstream>(f, std::ios::binary));
+			if (!colFiles.back()->is_open())
+				THROW_EXCEPTION_FMT("Error creating file '%s'", f.c_str());
+		}
+	}
+
+	size_t nRows = 0;
+	std::vector<std::vector<double>> block;
+	while (reader.readBlock(block))
+	{
+		const size_t n = block.empty() ? 0 : block[0].size();
+		nRows += n;
+
+		if (format == "csv")
+		{
+			for (size_t r = 0; r < n; r++)
+			{
+				for (size_t c = 0; c < block.size(); c++)
+					csv << (c > 0 ? ", " : "") << block[c][r];
+				csv << "\n";
+			}
+		}
+		else
+		{
+			for (size_t c = 0; c < block.size(); c++)
+				colFiles[c]->write(
+					reinterpret_cast<const char*>(block[c].data()),
+					sizeof(double) * n);
+		}
+	}
+
+	std::cout << "Exported " << nRows << " rows x " << names.size()
+			  << " columns to: " << out << "\n";
+
+	return 0;
+}
@@ -25,7 +25,10 @@ using cmd_t = std::function<int(void)>;
 int printListCommands();  // "help"
 int launchStandAloneServer();  // "server"
 int launchSimulation();  // "launch"
+int runSimulation();  // "run"
+int replayInputLog();  // "replay"
 int commandNode();  // "node"
 int commandTopic();  // "topic"
+int commandTelemetry();  // "telemetry"
 
 void commonLaunchServer();
@@ -132,9 +132,6 @@ class MVSimNode
 		TThreadParams() : obj(NULL), closing(false) {}
 	};
 	TThreadParams thread_params_;
-	mrpt::system::CTicTac realtime_tictac_;
-
-	double t_old_;  // = realtime_tictac_.Tac();
 	bool world_init_ok_;  //!< will be true after a success call to
 						  //! loadWorldModel()
 
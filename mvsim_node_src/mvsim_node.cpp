@@ -37,7 +37,6 @@ MVSimNode::MVSimNode(ros::NodeHandle& n)
 	  m_localn("~"),
 	  m_tf_br(),
 	  m_tfIdentity(tf::createIdentityQuaternion(), tf::Point(0, 0, 0)),
-	  t_old_(-1),
 	  world_init_ok_(false),
 	  m_period_ms_publish_tf(20),
 	  m_period_ms_teleop_refresh(100),
@@ -85,7 +84,8 @@ void MVSimNode::loadWorldModel(const std::string& world_xml_file)
 		"[MVSimNode::loadWorldModel] File does not exist!: '%s'",
 		world_xml_file.c_str());
 
-	// Load from XML:
+	// Load from XML (stopping the simulation, if it was already running):
+	mvsim_world_.stopRealtime();
 	rapidxml::file<> fil_xml(world_xml_file.c_str());
 	mvsim_world_.load_from_XML(fil_xml.data(), world_xml_file);
 
@@ -102,6 +102,7 @@ void MVSimNode::loadWorldModel(const std::string& world_xml_file)
  *----------------------------------------------------------------------------*/
 MVSimNode::~MVSimNode()
 {
+	mvsim_world_.stopRealtime();
 	thread_params_.closing = true;
 	thGUI_.join();
 }
@@ -126,30 +127,15 @@ void MVSimNode::spin()
 {
 	using namespace mvsim;
 
-	// Do simulation itself:
+	// Do simulation itself, in its own thread, paced with the wall clock:
 	// ========================================================================
-	// Handle 1st iter:
-	if (t_old_ < 0) t_old_ = realtime_tictac_.Tac();
-	// Compute how much time has passed to simulate in real-time:
-	double t_new = realtime_tictac_.Tac();
-	double incr_time = realtime_factor_ * (t_new - t_old_);
+	if (!world_init_ok_) return;
+	mvsim_world_.runRealtimeIfStopped(realtime_factor_);
 
-	if (incr_time < mvsim_world_.get_simul_timestep())  // Just in case the
-														// computer is *really
-														// fast*...
-		return;
-
-	// Simulate:
-	mvsim_world_.run_simulation(incr_time);
-
-	// t_old_simul = world.get_simul_time();
-	t_old_ = t_new;
-
-	const World::TListVehicles& vehs = mvsim_world_.getListOfVehicles();
-
-	// Publish new state to ROS
+	// Publish new state to ROS. The simulation runs in its own thread, so
+	// do not let it modify vehicles meanwhile:
 	// ========================================================================
-	this->spinNotifyROS();
+	mvsim_world_.runWithSimulationLocked([this]() { spinNotifyROS(); });
 
 	// GUI msgs, teleop, etc.
 	// ========================================================================
@@ -174,7 +160,9 @@ void MVSimNode::spin()
 				break;
 		};
 
-		{  // Test: Differential drive: Control raw forces
+		mvsim_world_.runWithSimulationLocked([&]() {
+			const World::TListVehicles& vehs =
+				mvsim_world_.getListOfVehicles();
 			txt2gui_tmp += mrpt::format(
 				"Selected vehicle: %u/%u\n",
 				static_cast<unsigned>(m_teleop_idx_veh + 1),
@@ -206,16 +194,27 @@ void MVSimNode::spin()
 				// Generic teleoperation interface for any controller that
 				// supports it:
 				{
+					// Keys are applied by the simulation thread, so they can
+					// be recorded (see World::startInputRecording()):
+					if (keyevent.keycode != 0)
+					{
+						World::TExternalInput in;
+						in.kind = World::TExternalInput::Kind::TeleopKey;
+						in.object = mvsim_world_.getObjectHandle(
+							it_veh->second->getName());
+						in.keycode = keyevent.keycode;
+						mvsim_world_.enqueueInput(in);
+					}
+
 					ControllerBaseInterface* controller =
 						it_veh->second->getControllerInterface();
 					ControllerBaseInterface::TeleopInput teleop_in;
 					ControllerBaseInterface::TeleopOutput teleop_out;
-					teleop_in.keycode = keyevent.keycode;
 					controller->teleop_interface(teleop_in, teleop_out);
 					txt2gui_tmp += teleop_out.append_gui_lines;
 				}
 			}
-		}
+		});
 
 		m_msg2gui = txt2gui_tmp;  // send txt msgs to show in the GUI
 
@@ -289,21 +288,23 @@ void MVSimNode::notifyROSWorldIsUpdated()
 {
 	MVSimVisitor_notifyROSWorldIsUpdated myvisitor(*this);
 
-	mvsim_world_.runVisitorOnWorldElements(myvisitor);
-	mvsim_world_.runVisitorOnVehicles(myvisitor);
-
-	// Create subscribers & publishers for each vehicle's stuff:
-	// ----------------------------------------------------
-	mvsim::World::TListVehicles& vehs = mvsim_world_.getListOfVehicles();
-	m_pubsub_vehicles.clear();
-	m_pubsub_vehicles.resize(vehs.size());
-	size_t idx = 0;
-	for (mvsim::World::TListVehicles::iterator it = vehs.begin();
-		 it != vehs.end(); ++it, ++idx)
-	{
-		mvsim::VehicleBase* veh = it->second;
-		initPubSubs(m_pubsub_vehicles[idx], veh);
-	}
+	mvsim_world_.runWithSimulationLocked([&]() {
+		mvsim_world_.runVisitorOnWorldElements(myvisitor);
+		mvsim_world_.runVisitorOnVehicles(myvisitor);
+
+		// Create subscribers & publishers for each vehicle's stuff:
+		// ----------------------------------------------------
+		mvsim::World::TListVehicles& vehs = mvsim_world_.getListOfVehicles();
+		m_pubsub_vehicles.clear();
+		m_pubsub_vehicles.resize(vehs.size());
+		size_t idx = 0;
+		for (mvsim::World::TListVehicles::iterator it = vehs.begin();
+			 it != vehs.end(); ++it, ++idx)
+		{
+			mvsim::VehicleBase* veh = it->second;
+			initPubSubs(m_pubsub_vehicles[idx], veh);
+		}
+	});
 
 	// Publish the static transform /world -> /map
 	sendStaticTF("/world", "/map", m_tfIdentity, m_sim_time);
@@ -454,18 +455,26 @@ void MVSimNode::initPubSubs(TPubSubPerVehicle& pubsubs, mvsim::VehicleBase* veh)
 void MVSimNode::onROSMsgCmdVel(
 	const geometry_msgs::Twist::ConstPtr& cmd, mvsim::VehicleBase* veh)
 {
-	mvsim::ControllerBaseInterface* controller = veh->getControllerInterface();
-
-	const bool ctrlAcceptTwist =
-		controller->setTwistCommand(cmd->linear.x, cmd->angular.z);
-
-	if (!ctrlAcceptTwist)
-	{
+	// The simulation runs in its own thread: look up the vehicle handle in
+	// the state it last published:
+	const auto st = mvsim_world_.getPublishedObjectsState();
+	if (!st) return;
+	const auto itName = st->names->find(veh->getName());
+	if (itName == st->names->end()) return;
+
+	// Applied by the simulation thread before its next timestep:
+	mvsim::World::TExternalInput in;
+	in.kind = mvsim::World::TExternalInput::Kind::TwistCommand;
+	in.object = itName->second;
+	in.vx = cmd->linear.x;
+	in.wz = cmd->angular.z;
+	in.onRefused = [name = veh->getName()]() {
 		ROS_DEBUG_THROTTLE(
 			5.0,
 			"*Warning* Vehicle's controller ['%s'] refuses Twist commands!",
-			veh->getName().c_str());
-	}
+			name.c_str());
+	};
+	mvsim_world_.enqueueInput(in);
 }
 
 /** Publish everything to be published at each simulation iteration */